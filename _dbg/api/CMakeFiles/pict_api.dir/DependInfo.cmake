@@ -0,0 +1,33 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/api/combination.cpp" "api/CMakeFiles/pict_api.dir/combination.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/combination.cpp.o.d"
+  "/root/repo/api/comboarena.cpp" "api/CMakeFiles/pict_api.dir/comboarena.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/comboarena.cpp.o.d"
+  "/root/repo/api/comboqueue.cpp" "api/CMakeFiles/pict_api.dir/comboqueue.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/comboqueue.cpp.o.d"
+  "/root/repo/api/constraintsolver.cpp" "api/CMakeFiles/pict_api.dir/constraintsolver.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/constraintsolver.cpp.o.d"
+  "/root/repo/api/deriver.cpp" "api/CMakeFiles/pict_api.dir/deriver.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/deriver.cpp.o.d"
+  "/root/repo/api/exclusion.cpp" "api/CMakeFiles/pict_api.dir/exclusion.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/exclusion.cpp.o.d"
+  "/root/repo/api/model.cpp" "api/CMakeFiles/pict_api.dir/model.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/model.cpp.o.d"
+  "/root/repo/api/parameter.cpp" "api/CMakeFiles/pict_api.dir/parameter.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/parameter.cpp.o.d"
+  "/root/repo/api/pictapi.cpp" "api/CMakeFiles/pict_api.dir/pictapi.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/pictapi.cpp.o.d"
+  "/root/repo/api/results.cpp" "api/CMakeFiles/pict_api.dir/results.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/results.cpp.o.d"
+  "/root/repo/api/rowbuilder.cpp" "api/CMakeFiles/pict_api.dir/rowbuilder.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/rowbuilder.cpp.o.d"
+  "/root/repo/api/simd.cpp" "api/CMakeFiles/pict_api.dir/simd.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/simd.cpp.o.d"
+  "/root/repo/api/task.cpp" "api/CMakeFiles/pict_api.dir/task.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/task.cpp.o.d"
+  "/root/repo/api/workerpool.cpp" "api/CMakeFiles/pict_api.dir/workerpool.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/workerpool.cpp.o.d"
+  "/root/repo/api/worklist.cpp" "api/CMakeFiles/pict_api.dir/worklist.cpp.o" "gcc" "api/CMakeFiles/pict_api.dir/worklist.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,39 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pict_api.dir/combination.cpp.o"
+  "CMakeFiles/pict_api.dir/combination.cpp.o.d"
+  "CMakeFiles/pict_api.dir/comboarena.cpp.o"
+  "CMakeFiles/pict_api.dir/comboarena.cpp.o.d"
+  "CMakeFiles/pict_api.dir/comboqueue.cpp.o"
+  "CMakeFiles/pict_api.dir/comboqueue.cpp.o.d"
+  "CMakeFiles/pict_api.dir/constraintsolver.cpp.o"
+  "CMakeFiles/pict_api.dir/constraintsolver.cpp.o.d"
+  "CMakeFiles/pict_api.dir/deriver.cpp.o"
+  "CMakeFiles/pict_api.dir/deriver.cpp.o.d"
+  "CMakeFiles/pict_api.dir/exclusion.cpp.o"
+  "CMakeFiles/pict_api.dir/exclusion.cpp.o.d"
+  "CMakeFiles/pict_api.dir/model.cpp.o"
+  "CMakeFiles/pict_api.dir/model.cpp.o.d"
+  "CMakeFiles/pict_api.dir/parameter.cpp.o"
+  "CMakeFiles/pict_api.dir/parameter.cpp.o.d"
+  "CMakeFiles/pict_api.dir/pictapi.cpp.o"
+  "CMakeFiles/pict_api.dir/pictapi.cpp.o.d"
+  "CMakeFiles/pict_api.dir/results.cpp.o"
+  "CMakeFiles/pict_api.dir/results.cpp.o.d"
+  "CMakeFiles/pict_api.dir/rowbuilder.cpp.o"
+  "CMakeFiles/pict_api.dir/rowbuilder.cpp.o.d"
+  "CMakeFiles/pict_api.dir/simd.cpp.o"
+  "CMakeFiles/pict_api.dir/simd.cpp.o.d"
+  "CMakeFiles/pict_api.dir/task.cpp.o"
+  "CMakeFiles/pict_api.dir/task.cpp.o.d"
+  "CMakeFiles/pict_api.dir/workerpool.cpp.o"
+  "CMakeFiles/pict_api.dir/workerpool.cpp.o.d"
+  "CMakeFiles/pict_api.dir/worklist.cpp.o"
+  "CMakeFiles/pict_api.dir/worklist.cpp.o.d"
+  "libpict.a"
+  "libpict.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pict_api.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,32 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/cli/ccommon.cpp" "cli/CMakeFiles/pict_cli.dir/ccommon.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/ccommon.cpp.o.d"
+  "/root/repo/cli/cmdline.cpp" "cli/CMakeFiles/pict_cli.dir/cmdline.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/cmdline.cpp.o.d"
+  "/root/repo/cli/common.cpp" "cli/CMakeFiles/pict_cli.dir/common.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/common.cpp.o.d"
+  "/root/repo/cli/cparser.cpp" "cli/CMakeFiles/pict_cli.dir/cparser.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/cparser.cpp.o.d"
+  "/root/repo/cli/ctokenizer.cpp" "cli/CMakeFiles/pict_cli.dir/ctokenizer.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/ctokenizer.cpp.o.d"
+  "/root/repo/cli/gcd.cpp" "cli/CMakeFiles/pict_cli.dir/gcd.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/gcd.cpp.o.d"
+  "/root/repo/cli/gcdexcl.cpp" "cli/CMakeFiles/pict_cli.dir/gcdexcl.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/gcdexcl.cpp.o.d"
+  "/root/repo/cli/gcdmodel.cpp" "cli/CMakeFiles/pict_cli.dir/gcdmodel.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/gcdmodel.cpp.o.d"
+  "/root/repo/cli/gcdzdd.cpp" "cli/CMakeFiles/pict_cli.dir/gcdzdd.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/gcdzdd.cpp.o.d"
+  "/root/repo/cli/model.cpp" "cli/CMakeFiles/pict_cli.dir/model.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/model.cpp.o.d"
+  "/root/repo/cli/mparser.cpp" "cli/CMakeFiles/pict_cli.dir/mparser.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/mparser.cpp.o.d"
+  "/root/repo/cli/pict.cpp" "cli/CMakeFiles/pict_cli.dir/pict.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/pict.cpp.o.d"
+  "/root/repo/cli/strings.cpp" "cli/CMakeFiles/pict_cli.dir/strings.cpp.o" "gcc" "cli/CMakeFiles/pict_cli.dir/strings.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_dbg/api/CMakeFiles/pict_api.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
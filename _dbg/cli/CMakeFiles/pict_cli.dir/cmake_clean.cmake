@@ -0,0 +1,35 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pict_cli.dir/ccommon.cpp.o"
+  "CMakeFiles/pict_cli.dir/ccommon.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/cmdline.cpp.o"
+  "CMakeFiles/pict_cli.dir/cmdline.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/common.cpp.o"
+  "CMakeFiles/pict_cli.dir/common.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/cparser.cpp.o"
+  "CMakeFiles/pict_cli.dir/cparser.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/ctokenizer.cpp.o"
+  "CMakeFiles/pict_cli.dir/ctokenizer.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/gcd.cpp.o"
+  "CMakeFiles/pict_cli.dir/gcd.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/gcdexcl.cpp.o"
+  "CMakeFiles/pict_cli.dir/gcdexcl.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/gcdmodel.cpp.o"
+  "CMakeFiles/pict_cli.dir/gcdmodel.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/gcdzdd.cpp.o"
+  "CMakeFiles/pict_cli.dir/gcdzdd.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/model.cpp.o"
+  "CMakeFiles/pict_cli.dir/model.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/mparser.cpp.o"
+  "CMakeFiles/pict_cli.dir/mparser.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/pict.cpp.o"
+  "CMakeFiles/pict_cli.dir/pict.cpp.o.d"
+  "CMakeFiles/pict_cli.dir/strings.cpp.o"
+  "CMakeFiles/pict_cli.dir/strings.cpp.o.d"
+  "pict"
+  "pict.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pict_cli.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,33 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/cli/ccommon.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/ccommon.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/ccommon.cpp.o.d"
+  "/root/repo/cli/cmdline.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/cmdline.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/cmdline.cpp.o.d"
+  "/root/repo/cli/common.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/common.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/common.cpp.o.d"
+  "/root/repo/cli/cparser.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/cparser.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/cparser.cpp.o.d"
+  "/root/repo/cli/ctokenizer.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/ctokenizer.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/ctokenizer.cpp.o.d"
+  "/root/repo/cli/gcd.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/gcd.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/gcd.cpp.o.d"
+  "/root/repo/cli/gcdexcl.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/gcdexcl.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/gcdexcl.cpp.o.d"
+  "/root/repo/cli/gcdmodel.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/gcdmodel.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/gcdmodel.cpp.o.d"
+  "/root/repo/cli/gcdzdd.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/gcdzdd.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/gcdzdd.cpp.o.d"
+  "/root/repo/cli/model.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/model.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/model.cpp.o.d"
+  "/root/repo/cli/mparser.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/mparser.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/mparser.cpp.o.d"
+  "/root/repo/cli/pict.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/pict.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/pict.cpp.o.d"
+  "/root/repo/cli/strings.cpp" "clidll/CMakeFiles/pict_dll.dir/__/cli/strings.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/__/cli/strings.cpp.o.d"
+  "/root/repo/clidll/dllmain.cpp" "clidll/CMakeFiles/pict_dll.dir/dllmain.cpp.o" "gcc" "clidll/CMakeFiles/pict_dll.dir/dllmain.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_dbg/api/CMakeFiles/pict_api.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
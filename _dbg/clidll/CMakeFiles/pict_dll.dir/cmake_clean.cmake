@@ -0,0 +1,37 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pict_dll.dir/__/cli/ccommon.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/ccommon.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/cmdline.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/cmdline.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/common.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/common.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/cparser.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/cparser.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/ctokenizer.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/ctokenizer.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/gcd.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/gcd.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/gcdexcl.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/gcdexcl.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/gcdmodel.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/gcdmodel.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/gcdzdd.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/gcdzdd.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/model.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/model.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/mparser.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/mparser.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/pict.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/pict.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/__/cli/strings.cpp.o"
+  "CMakeFiles/pict_dll.dir/__/cli/strings.cpp.o.d"
+  "CMakeFiles/pict_dll.dir/dllmain.cpp.o"
+  "CMakeFiles/pict_dll.dir/dllmain.cpp.o.d"
+  "libpict.pdb"
+  "libpict.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pict_dll.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
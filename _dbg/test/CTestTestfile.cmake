@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_dbg/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(run_pict "perl" "test.pl" "/root/repo/_dbg/cli/pict" "dbg.log")
+set_tests_properties(run_pict PROPERTIES  WORKING_DIRECTORY "/root/repo/test" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;1;add_test;/root/repo/test/CMakeLists.txt;0;")
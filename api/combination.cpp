@@ -1,139 +1,143 @@
 #include "generator.h"
-#include <cstring>
+#include "simd.h"
 
 namespace pictcore
 {
 
-unsigned int Combination::m_lastUsedId = UNDEFINED_ID;
 
 //
 //
 //
-void Combination::SetMapSize( int size, TrackType trackType )
+void CoverageMap::Attach( Word* bits, int size, TrackType val )
 {
-    m_range = size;
-    m_bitvec = new TrackType[ size ];
+    m_words = ( size + 63 ) / 64;
+    m_bits  = bits;
+    std::fill( m_bits, m_bits + 2 * m_words, Word( 0 ) );
 
-    memset( m_bitvec, trackType, size * sizeof( TrackType ) );
-    if( OPEN == trackType )
+    Word* plane = OPEN == val ? openPlane() : EXCLUDED == val ? excludedPlane() : nullptr;
+    if( nullptr != plane && size > 0 )
     {
-        m_openCount = size;
-        m_model->GlobalZerosCount += size;
+        std::fill( plane, plane + m_words, ~Word( 0 ) );
+        // keep the bits past the end clear so whole words can be counted
+        if( size & 63 ) plane[ m_words - 1 ] = bit( size ) - 1;
     }
 }
 
 //
-// Binds all associated parameters according to a key value
-// The computation of parameter values from key is the inverse of Complete below
-// Returns the number of parameters we bound
 //
-int Combination::Bind( int value, WorkList &worklist )
+//
+void CoverageMap::Set( int n, TrackType val )
 {
-    int bound = 0;
-    // Mark all as pending so we don't add any to the worklist
-    for( auto param : m_params )
-    {
-        param->MarkPending();
-    }
+    Word* open     = openPlane()     + ( n >> 6 );
+    Word* excluded = excludedPlane() + ( n >> 6 );
+    if( OPEN     == val ) *open     |= bit( n ); else *open     &= ~bit( n );
+    if( EXCLUDED == val ) *excluded |= bit( n ); else *excluded &= ~bit( n );
+}
 
-    for( ParamCollection::reverse_iterator iter =  m_params.rbegin();
-                                           iter != m_params.rend();
-                                         ++iter )
-    {
-        if( !( *iter )->GetBoundCount() )
-        {
-            ( *iter )->Bind( value % ( *iter )->GetValueCount(), worklist );
-            ++bound;
-        }
-        value /= ( *iter )->GetValueCount();
-    }
+//
+//
+//
+int CoverageMap::CountOpen( int first, int count ) const
+{
+    return( simd::CountRun( openPlane(), first, count ) );
+}
 
-    return bound;
+//
+//
+//
+int CoverageMap::CountOpen( const int* positions, int count ) const
+{
+    return( simd::CountSet( openPlane(), positions, count ) );
 }
 
 //
-// Count the zeros in the projection of the current set of bound values
 //
-int Combination::Feasible()
+//
+int CoverageMap::ExcludeRun( int first, int count )
 {
-    int* workbuf = m_model->GetTask()->GetWorkbuf();
+    if( count <= 0 ) return( 0 );
 
-    int nWorkVals = 1;
-    workbuf[ 0 ] = 0;
-    for( Parameter* param : m_params )
+    int open = 0;
+    int last = first + count - 1;
+    for( int w = first >> 6; w <= last >> 6; ++w )
     {
-        for( int i = 0; i < nWorkVals; i++ )
-        {
-            workbuf[ i ] *= param->GetValueCount();
-        }
-        int nCurrentVal = (int) param->GetLast();
-        if( param->GetBoundCount() )
-        {
-            for( int i = 0; i < nWorkVals; ++i )
-            {
-                workbuf[ i ] += nCurrentVal;
-            }
-        }
-        else
-        {
-            for( int i = 0; i < nWorkVals; ++i )
-            {
-                for( int addend = 1; addend < param->GetValueCount(); ++addend )
-                {
-                    workbuf[ i + nWorkVals*addend ] = workbuf[ i ] + addend;
-                }
-            }
-            nWorkVals *= param->GetValueCount();
-        }
+        Word mask = ~Word( 0 );
+        if( w == first >> 6 ) mask &= ~Word( 0 ) << ( first & 63 );
+        if( w == last  >> 6 ) mask &= ~Word( 0 ) >> ( 63 - ( last & 63 ) );
+
+        open += simd::Popcount( openPlane()[ w ] & mask );
+        openPlane()[ w ]     &= ~mask;
+        excludedPlane()[ w ] |= mask;
     }
+    return( open );
+}
+
+//
+// Picks the smallest multiplier m and shift s for which n * m >> s equals n / d for all
+// 0 <= n < 2^31, see Granlund and Montgomery; m fits in 32 bits and n * m in 64
+//
+Divisor::Divisor( int divisor ) :
+    m_divisor( divisor )
+{
+    assert( divisor > 0 );
+    int bits = 0;
+    while( ( uint64_t( 1 ) << bits ) < static_cast<uint64_t>( divisor ) ) ++bits;
+
+    m_shift      = 31 + bits;
+    m_multiplier = ( uint64_t( 1 ) << m_shift ) / static_cast<uint64_t>( divisor ) + 1;
+}
+
+//
+//
+//
+void Combination::SetMapSize( int size, uint64_t* bits, TrackType trackType )
+{
+    m_range = size;
+    m_coverage.Attach( bits, size, trackType );
 
-    // Now count the zeros corresponding to the open combinations
-    int zeros = 0;
-    for( int i = 0; i < nWorkVals; ++i )
+    if( OPEN == trackType )
     {
-        if( ComboStatus::Open == m_bitvec[ workbuf[ i ] ] )
-        {
-            ++zeros;
-        }
+        m_openCount = size;
+        m_model->GlobalZerosCount += size;
     }
-
-    return zeros;
 }
 
 //
-// See if the key value matches bound values
+// Binds all associated parameters according to a key value
+// The computation of parameter values from key is the inverse of Complete below
+// Returns the number of parameters we bound
 //
-ComboStatus Combination::Feasible( int value )
+int Combination::Bind( int value, WorkList &worklist )
 {
-    if( EXCLUDED == m_bitvec[ value ] )
+    int bound = 0;
+    // Mark all as pending so we don't add any to the worklist
+    for( int n = 0; n < m_paramCount; ++n )
     {
-        return ComboStatus::Excluded;
+        m_params[ n ]->MarkPending();
     }
-    ComboStatus retval = ( COVERED == m_bitvec[ value ] ) ? ComboStatus::CoveredMatch : ComboStatus::Open;
-    for( ParamCollection::reverse_iterator iter = m_params.rbegin(); iter != m_params.rend(); ++iter )
+
+    for( int n = m_paramCount - 1; n >= 0; --n )
     {
-        if( ( *iter )->GetBoundCount() && 
-            static_cast<int>(( *iter )->GetLast()) != value % ( *iter )->GetValueCount() )
+        int current = m_radices[ n ].DivMod( value );
+        if( !m_params[ n ]->GetBoundCount() )
         {
-            return ComboStatus::Excluded;
+            m_params[ n ]->Bind( current, worklist );
+            ++bound;
         }
-        value /= ( *iter )->GetValueCount();
     }
 
-    return retval;
+    return bound;
 }
 
 //
 //
 //
-int Combination::Weight( int value )
+int Combination::Weight( int value ) const
 {
     int weight = 0;
-    for( ParamCollection::reverse_iterator iter = m_params.rbegin(); iter != m_params.rend(); ++iter )
+    for( int n = m_paramCount - 1; n >= 0; --n )
     {
-        Parameter* param = *iter;
-        weight += param->GetWeight( value % param->GetValueCount() );
-        value /= param->GetValueCount();
+        weight += m_params[ n ]->GetWeight( m_radices[ n ].DivMod( value ) );
     }
 
     return weight;
@@ -144,24 +148,23 @@ int Combination::Weight( int value )
 //
 int Combination::AddBinding()
 {
-    if( ++m_boundCount == static_cast<int>(m_params.size()) )
+    if( ++m_boundCount == m_paramCount )
     {
         // compute which zero we're setting
         size_t value = 0;
-        for( ParamCollection::iterator iter = m_params.begin(); iter != m_params.end(); ++iter )
+        for( int n = 0; n < m_paramCount; ++n )
         {
-            assert( ( *iter )->GetBoundCount() );
-            value = ( value * ( *iter )->GetValueCount() ) + ( *iter )->GetLast();
+            assert( m_params[ n ]->GetBoundCount() );
+            value += m_params[ n ]->GetLast() * m_strides[ n ];
         }
 
         // check to see if it's zero
-        if( OPEN == m_bitvec[ value ] )
+        if( m_coverage.IsOpen( static_cast<int>( value ) ) )
         {
             // if so, set it and count it locally and globally
             assert( value <= (size_t) m_range );
-            m_bitvec[ value ] = COVERED;
-            --m_openCount;
-            --m_model->GlobalZerosCount;
+            m_coverage.Set( static_cast<int>( value ), COVERED );
+            updateOpenCount( -1 );
         }
     }
 
@@ -169,77 +172,75 @@ int Combination::AddBinding()
 }
 
 //
-// Recurse through parameters
-// If bound in exclusion, use exclusion value
-//  else iterate over all values
-// Terminate recursion: set result value excluded, update count
-//
-void Combination::applyExclusion( Exclusion& excl, int index, ParamCollection::iterator pos )
-{
-    if( m_params.end() == pos )
-    {
-        assert( index <= m_range );
-        if( OPEN == m_bitvec[ index ] )
-        {
-            --m_openCount;
-            --m_model->GlobalZerosCount;
-        }
-        m_bitvec[ index ] = EXCLUDED;
-    }
-    else
-    {
-        // Is *pos a parameter in the exclusion?
-        Exclusion::iterator ie = find_if( excl.begin(),
-                                          excl.end(),
-                                          [pos](const ExclusionTerm et) {
-                                              return et.first == *pos;
-                                          } );
-        // parameter is bound to a value in the exclusion
-        if( excl.end() != ie )
-        {
-            applyExclusion( excl, index * ( *pos )->GetValueCount() + ie->second, pos + 1 );
-        }
-        // parameter ranges over all values in the exclusion
-        else
-        {
-            for( int n = 0; n < ( *pos )->GetValueCount(); ++n )
-            {
-                applyExclusion( excl, index * ( *pos )->GetValueCount() + n, pos + 1 );
-            }
-        }
-    }
-}
-
-//
-//
+// Finds where the exclusion's parameters sit in the combination and hands off to ExcludeTuples
 //
 void Combination::ApplyExclusion( Exclusion& excl )
 {
     // only if this exclusion's parameters exist in the combo
+    std::vector<int> positions;
     for( Exclusion::iterator it = excl.begin(); it != excl.end(); ++it )
     {
-        ParamCollection::iterator ip = find( m_params.begin(), m_params.end(), it->first );
-        if( ip == m_params.end() ) return;
+        Parameter** ip = std::find( m_params, m_params + m_paramCount, it->first );
+        if( ip == m_params + m_paramCount ) return;
+        positions.push_back( static_cast<int>( ip - m_params ) );
     }
 
-    applyExclusion( excl, 0, m_params.begin() );
+    DropOpen( ExcludeTuples( excl, positions.data() ) );
 }
 
 //
+// Parameters bound in the exclusion contribute a fixed offset, the others range over
+//  all their values; the trailing ones of those make up runs of consecutive tuples
+// The rest are stepped through like an odometer, excluding a run at a time
 //
-//
-bool Combination::ViolatesExclusion()
+int Combination::ExcludeTuples( const Exclusion& excl, const int* positions )
 {
-    size_t nKey = 0;
-    for( ParamCollection::iterator iter = m_params.begin(); iter != m_params.end(); ++iter )
+    int base = 0;
+    std::vector<char> bound( m_paramCount, 0 );
+    for( Exclusion::const_iterator it = excl.begin(); it != excl.end(); ++it, ++positions )
+    {
+        // a parameter that appears twice takes the value of its first term
+        if( bound[ *positions ] ) continue;
+        bound[ *positions ] = 1;
+        base += it->second * m_strides[ *positions ];
+    }
+
+    std::vector<int> free;
+    for( int n = 0; n < m_paramCount; ++n )
+    {
+        if( !bound[ n ] ) free.push_back( n );
+    }
+
+    int runLength = 1;
+    int lead = m_paramCount;
+    while( !free.empty() && free.back() == lead - 1 )
     {
-        nKey *= ( *iter )->GetValueCount();
-        size_t nCurrentVal = ( *iter )->GetLast();
-        assert( ( *iter )->GetBoundCount() );
-        nKey += nCurrentVal;
+        --lead;
+        runLength *= m_radices[ lead ].Get();
+        free.pop_back();
     }
 
-    return ( EXCLUDED == m_bitvec[ nKey ] );
+    int excluded = 0;
+    std::vector<int> digits( free.size(), 0 );
+    int index = base;
+    for( ;; )
+    {
+        assert( index + runLength <= m_range );
+        excluded += m_coverage.ExcludeRun( index, runLength );
+
+        int k = static_cast<int>( free.size() ) - 1;
+        for( ; k >= 0; --k )
+        {
+            int n = free[ k ];
+            index += m_strides[ n ];
+            if( ++digits[ k ] < m_radices[ n ].Get() ) break;
+            index -= digits[ k ] * m_strides[ n ];
+            digits[ k ] = 0;
+        }
+        if( k < 0 ) break;
+    }
+
+    return( excluded );
 }
 
 //
@@ -250,31 +251,38 @@ bool Combination::ViolatesExclusion()
 void Combination::SetOpen( int index )
 {
     assert( index < m_range );
-    if( OPEN != m_bitvec[ index ] )
+    if( !m_coverage.IsOpen( index ) )
     {
-        m_bitvec[ index ] = OPEN;
-        ++m_openCount;
-        ++m_model->GlobalZerosCount;
+        m_coverage.Set( index, OPEN );
+        updateOpenCount( 1 );
     }
 }
 
 //
+// Keeps the local and global zero counts and the model's combo queue in sync
 //
-//
-Combination::Combination( Model *M ) :
-    m_bitvec( nullptr ), m_range( 0 ), m_openCount( 0 ), m_boundCount( 0 ), m_model( M )
+void Combination::updateOpenCount( int delta )
 {
-    m_id = ++m_lastUsedId;
-    DOUT( L"Combination created: " << m_id << endl );
+    int oldCount = m_openCount;
+    m_openCount += delta;
+    m_model->GlobalZerosCount += delta;
+
+    if( m_queued )
+    {
+        m_model->GetComboQueue().Move( this, oldCount );
+    }
 }
 
 //
 //
 //
-Combination::~Combination()
+Combination::Combination( Model *M, Parameter** params, const int* strides, const Divisor* radices, int paramCount ) :
+    m_params( params ), m_strides( strides ), m_radices( radices ), m_paramCount( paramCount ),
+    m_range( 0 ), m_openCount( 0 ), m_boundCount( 0 ), m_model( M ),
+    m_queuePrev( nullptr ), m_queueNext( nullptr ), m_queued( false )
 {
-    DOUT( L"Combination deleted: " << m_id << endl );
-    if( nullptr != m_bitvec ) delete[] m_bitvec;
+    m_id = M->GetTask()->NewCombinationId();
+    DOUT( L"Combination created: " << m_id << endl );
 }
 
 //
@@ -289,7 +297,7 @@ void Combination::Print()
         DOUT( ( *this )[ n ].GetName() << L" [" << ( *this )[ n ].GetSequence() << L"] " );
     DOUT( L" " );
     for( int n = 0; n < m_range; ++n )
-        DOUT( m_bitvec[ n ] << L" " );
+        DOUT( m_coverage.Get( n ) << L" " );
     DOUT( L"\n" );
 }
 
@@ -0,0 +1,89 @@
+#include "generator.h"
+#include <new>
+#include <type_traits>
+using namespace std;
+
+namespace pictcore
+{
+
+// Clear() releases the slabs without running any destructors
+static_assert( is_trivially_destructible<Combination>::value, "Combination must be trivially destructible" );
+
+// the first chunk of each slab, every next one is twice the size of the previous one
+const size_t MinChunkSize = 16 * 1024;
+const size_t MaxChunkSize = 16 * 1024 * 1024;
+
+//
+//
+//
+void* ComboArena::Slab::Allocate( size_t size, size_t align )
+{
+    uintptr_t next = ( reinterpret_cast<uintptr_t>( m_next ) + align - 1 ) & ~( uintptr_t( align ) - 1 );
+    if( nullptr == m_next || next + size > reinterpret_cast<uintptr_t>( m_end ) )
+    {
+        size_t chunkSize = MinChunkSize << min<size_t>( m_chunks.size(), 10 );
+        chunkSize = max( min( chunkSize, MaxChunkSize ), size + align );
+
+        char* chunk = new char[ chunkSize ];
+        m_chunks.push_back( chunk );
+        m_next = chunk;
+        m_end  = chunk + chunkSize;
+        next   = ( reinterpret_cast<uintptr_t>( m_next ) + align - 1 ) & ~( uintptr_t( align ) - 1 );
+    }
+
+    m_next = reinterpret_cast<char*>( next + size );
+    return( reinterpret_cast<void*>( next ) );
+}
+
+//
+//
+//
+void ComboArena::Slab::Release()
+{
+    for( auto chunk : m_chunks )
+    {
+        delete[] chunk;
+    }
+    m_chunks.clear();
+    m_next = nullptr;
+    m_end  = nullptr;
+}
+
+//
+// The coverage map is sized to the product of the value counts of the parameters
+//
+Combination* ComboArena::NewCombination( Model* model, const ParamCollection& params, TrackType val )
+{
+    int paramCount = static_cast<int>( params.size() );
+    Parameter** paramList = static_cast<Parameter**>( m_paramLists.Allocate( paramCount * sizeof( Parameter* ), alignof( Parameter* ) ) );
+    int*        strides   = static_cast<int*>       ( m_paramLists.Allocate( paramCount * sizeof( int ),        alignof( int ) ) );
+    Divisor*    radices   = static_cast<Divisor*>   ( m_paramLists.Allocate( paramCount * sizeof( Divisor ),    alignof( Divisor ) ) );
+    copy( params.begin(), params.end(), paramList );
+
+    // the last parameter varies fastest
+    int size = 1;
+    for( int n = paramCount - 1; n >= 0; --n )
+    {
+        strides[ n ] = size;
+        new( radices + n ) Divisor( params[ n ]->GetValueCount() );
+        size *= params[ n ]->GetValueCount();
+    }
+    uint64_t* bits = static_cast<uint64_t*>( m_bitmaps.Allocate( CoverageMap::WordCount( size ) * sizeof( uint64_t ), alignof( uint64_t ) ) );
+
+    void* header = m_headers.Allocate( sizeof( Combination ), alignof( Combination ) );
+    Combination* combo = new( header ) Combination( model, paramList, strides, radices, paramCount );
+    combo->SetMapSize( size, bits, val );
+    return( combo );
+}
+
+//
+//
+//
+void ComboArena::Clear()
+{
+    m_headers.Release();
+    m_paramLists.Release();
+    m_bitmaps.Release();
+}
+
+}
@@ -0,0 +1,97 @@
+#include "generator.h"
+using namespace std;
+
+namespace pictcore
+{
+
+//
+//
+//
+void ComboQueue::Build( ComboCollection& combos )
+{
+    Clear();
+    for( auto combo : combos )
+    {
+        link( combo, combo->GetOpenCount() );
+        combo->m_queued = true;
+    }
+}
+
+//
+//
+//
+void ComboQueue::Clear()
+{
+    for( auto head : m_buckets )
+    {
+        for( Combination* combo = head; combo != nullptr; combo = combo->m_queueNext )
+        {
+            combo->m_queued = false;
+        }
+    }
+    m_buckets.clear();
+    m_top = 0;
+}
+
+//
+//
+//
+void ComboQueue::Move( Combination* combo, int oldCount )
+{
+    assert( combo->m_queued );
+    unlink( combo, oldCount );
+    link( combo, combo->GetOpenCount() );
+}
+
+//
+//
+//
+void ComboQueue::link( Combination* combo, int count )
+{
+    assert( count >= 0 );
+    if( count >= static_cast<int>( m_buckets.size() ) )
+    {
+        m_buckets.resize( count + 1, nullptr );
+    }
+
+    combo->m_queuePrev = nullptr;
+    combo->m_queueNext = m_buckets[ count ];
+    if( nullptr != combo->m_queueNext )
+    {
+        combo->m_queueNext->m_queuePrev = combo;
+    }
+    m_buckets[ count ] = combo;
+
+    if( count > m_top ) m_top = count;
+}
+
+//
+//
+//
+void ComboQueue::unlink( Combination* combo, int count )
+{
+    if( nullptr != combo->m_queuePrev )
+    {
+        combo->m_queuePrev->m_queueNext = combo->m_queueNext;
+    }
+    else
+    {
+        assert( m_buckets[ count ] == combo );
+        m_buckets[ count ] = combo->m_queueNext;
+    }
+
+    if( nullptr != combo->m_queueNext )
+    {
+        combo->m_queueNext->m_queuePrev = combo->m_queuePrev;
+    }
+
+    combo->m_queuePrev = nullptr;
+    combo->m_queueNext = nullptr;
+
+    while( m_top > 0 && nullptr == m_buckets[ m_top ] )
+    {
+        --m_top;
+    }
+}
+
+}
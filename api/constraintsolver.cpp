@@ -0,0 +1,341 @@
+#include "generator.h"
+using namespace std;
+
+namespace pictcore
+{
+
+//
+// Exclusions with a parameter the solver doesn't know or with two terms contradicting each
+//  other can't be matched by a row and are left out
+//
+void ConstraintSolver::Build( const ParamCollection& params, const ParamCollection& context, const ExclusionCollection& exclusions )
+{
+    Clear();
+
+    m_boundable = static_cast<int>( params.size() );
+    int valueCount = 0;
+    for( int p = 0; p < static_cast<int>( params.size() + context.size() ); ++p )
+    {
+        Parameter* param = p < m_boundable ? params[ p ] : context[ p - m_boundable ];
+        if( !m_index.insert( make_pair( param, static_cast<int>( m_params.size() ) ) ).second ) continue;
+
+        m_params.push_back( param );
+        m_valueBegin.push_back( valueCount );
+        m_options.push_back( param->GetValueCount() );
+        valueCount += param->GetValueCount();
+    }
+    m_valueBegin.push_back( valueCount );
+    m_struck.assign( valueCount, 0 );
+    m_assigned.assign( m_params.size(), -1 );
+    m_inPlay.assign( m_params.size(), 0 );
+    m_occurrences.assign( m_params.size(), vector<Occurrence>() );
+
+    vector<Term> terms;
+    for( auto & excl : exclusions )
+    {
+        if( excl.empty() )
+        {
+            m_infeasible = true;
+            continue;
+        }
+
+        // terms are sorted by parameter so a parameter's terms are next to each other
+        bool usable = true;
+        terms.clear();
+        for( auto & term : excl )
+        {
+            int param = IndexOf( term.first );
+            if( param < 0 || ( !terms.empty() && terms.back().param == param && terms.back().value != term.second ) )
+            {
+                usable = false;
+                break;
+            }
+            if( terms.empty() || terms.back().param != param )
+            {
+                terms.push_back( Term{ param, term.second } );
+            }
+        }
+        if( !usable ) continue;
+
+        if( m_termBegin.empty() ) m_termBegin.push_back( 0 );
+        int index = static_cast<int>( m_termBegin.size() ) - 1;
+        for( auto & term : terms )
+        {
+            m_terms.push_back( term );
+            m_occurrences[ term.param ].push_back( Occurrence{ index, term.value } );
+            ++m_inPlay[ term.param ];
+        }
+        m_termBegin.push_back( static_cast<int>( m_terms.size() ) );
+        m_matched.push_back( 0 );
+        m_killed.push_back( 0 );
+
+        // a single term is all that's left to match from the start
+        if( 1 == terms.size() )
+        {
+            strike( terms.front().param, terms.front().value );
+        }
+    }
+}
+
+//
+//
+//
+void ConstraintSolver::Clear()
+{
+    m_params.clear();
+    m_index.clear();
+    m_boundable = 0;
+    m_infeasible = false;
+    m_termBegin.clear();
+    m_terms.clear();
+    m_matched.clear();
+    m_killed.clear();
+    m_occurrences.clear();
+    m_assigned.clear();
+    m_valueBegin.clear();
+    m_struck.clear();
+    m_options.clear();
+    m_inPlay.clear();
+    m_bindings.clear();
+    m_bindingsConsistent = true;
+}
+
+//
+//
+//
+int ConstraintSolver::IndexOf( const Parameter* param ) const
+{
+    unordered_map<const Parameter*, int>::const_iterator found = m_index.find( param );
+    return( found == m_index.end() ? -1 : found->second );
+}
+
+//
+// Bindings only ever get added while a row is built so they stay assigned from one question
+//  to the next as long as they remain the same; all else is unassigned before returning
+//
+bool ConstraintSolver::CanComplete( const vector<ExclusionTerm>& assumptions, bool useBindings, vector<int>* solution )
+{
+    if( m_infeasible ) return( false );
+
+    bool unchanged = useBindings;
+    for( vector<int>::iterator ip = m_bindings.begin(); unchanged && ip != m_bindings.end(); ++ip )
+    {
+        unchanged = m_params[ *ip ]->GetBoundCount() && static_cast<int>( m_params[ *ip ]->GetLast() ) == m_assigned[ *ip ];
+    }
+    if( !unchanged )
+    {
+        releaseBindings();
+    }
+
+    if( useBindings )
+    {
+        for( int p = 0; p < m_boundable; ++p )
+        {
+            if( m_assigned[ p ] < 0 && m_params[ p ]->GetBoundCount() )
+            {
+                m_bindings.push_back( p );
+                if( !assign( p, static_cast<int>( m_params[ p ]->GetLast() ) ) ) m_bindingsConsistent = false;
+            }
+        }
+    }
+
+    vector<int> trail;
+    bool complete = m_bindingsConsistent;
+    for( auto & term : assumptions )
+    {
+        if( !complete ) break;
+
+        int param = IndexOf( term.first );
+        if( param < 0 ) continue;
+
+        if( m_assigned[ param ] >= 0 )
+        {
+            complete = m_assigned[ param ] == term.second;
+        }
+        else
+        {
+            trail.push_back( param );
+            complete = assign( param, term.second );
+        }
+    }
+
+    if( complete )
+    {
+        m_solution = solution;
+        complete = search();
+        m_solution = nullptr;
+    }
+
+    for( vector<int>::reverse_iterator ip = trail.rbegin(); ip != trail.rend(); ++ip )
+    {
+        unassign( *ip );
+    }
+
+    return( complete );
+}
+
+//
+// The parameter with the fewest options goes first; parameters none of whose exclusions
+//  are in play any more can take any value and are left alone
+//
+bool ConstraintSolver::search()
+{
+    int next = -1;
+    for( int p = 0; p < static_cast<int>( m_params.size() ); ++p )
+    {
+        if( m_assigned[ p ] < 0 && m_inPlay[ p ] > 0 && ( next < 0 || m_options[ p ] < m_options[ next ] ) )
+        {
+            next = p;
+        }
+    }
+
+    if( next < 0 )
+    {
+        if( nullptr != m_solution )
+        {
+            *m_solution = m_assigned;
+            for( auto & value : *m_solution )
+            {
+                if( value < 0 ) value = 0;
+            }
+        }
+        return( true );
+    }
+
+    for( int value = 0; value < m_params[ next ]->GetValueCount(); ++value )
+    {
+        if( m_struck[ m_valueBegin[ next ] + value ] > 0 ) continue;
+
+        bool complete = assign( next, value ) && search();
+        unassign( next );
+        if( complete ) return( true );
+    }
+    return( false );
+}
+
+//
+// Returns false if the exclusions now rule out the row: one of them is matched entirely
+//  or a parameter not yet assigned has no options left
+//
+bool ConstraintSolver::assign( int param, int value )
+{
+    bool consistent = true;
+    m_assigned[ param ] = value;
+
+    for( auto & occurrence : m_occurrences[ param ] )
+    {
+        int excl = occurrence.exclusion;
+
+        // if the exclusion was down to one term, it was this parameter's
+        bool wasUnit = isUnit( excl );
+        if( occurrence.value == value )
+        {
+            ++m_matched[ excl ];
+        }
+        else if( 0 == m_killed[ excl ]++ )
+        {
+            for( int t = m_termBegin[ excl ]; t < m_termBegin[ excl + 1 ]; ++t )
+            {
+                --m_inPlay[ m_terms[ t ].param ];
+            }
+        }
+        if( wasUnit ) restore( param, occurrence.value );
+
+        if( m_matched[ excl ] == termCount( excl ) )
+        {
+            consistent = false;
+        }
+        else if( isUnit( excl ) )
+        {
+            const Term& term = openTerm( excl );
+            if( !strike( term.param, term.value ) ) consistent = false;
+        }
+    }
+    return( consistent );
+}
+
+//
+// Exactly reverses assign, the counts do not depend on the order parameters are unassigned in
+//
+void ConstraintSolver::unassign( int param )
+{
+    int value = m_assigned[ param ];
+    for( auto & occurrence : m_occurrences[ param ] )
+    {
+        int excl = occurrence.exclusion;
+
+        if( isUnit( excl ) )
+        {
+            const Term& term = openTerm( excl );
+            restore( term.param, term.value );
+        }
+
+        if( occurrence.value == value )
+        {
+            --m_matched[ excl ];
+        }
+        else if( 0 == --m_killed[ excl ] )
+        {
+            for( int t = m_termBegin[ excl ]; t < m_termBegin[ excl + 1 ]; ++t )
+            {
+                ++m_inPlay[ m_terms[ t ].param ];
+            }
+        }
+
+        // with this parameter open again, the exclusion may be down to its term
+        if( isUnit( excl ) ) strike( param, occurrence.value );
+    }
+    m_assigned[ param ] = -1;
+}
+
+//
+//
+//
+void ConstraintSolver::releaseBindings()
+{
+    for( vector<int>::reverse_iterator ip = m_bindings.rbegin(); ip != m_bindings.rend(); ++ip )
+    {
+        unassign( *ip );
+    }
+    m_bindings.clear();
+    m_bindingsConsistent = true;
+}
+
+//
+// The one term of an exclusion whose parameter isn't assigned yet
+//
+const ConstraintSolver::Term& ConstraintSolver::openTerm( int excl ) const
+{
+    int t = m_termBegin[ excl ];
+    while( m_assigned[ m_terms[ t ].param ] >= 0 )
+    {
+        ++t;
+    }
+    assert( t < m_termBegin[ excl + 1 ] );
+    return( m_terms[ t ] );
+}
+
+//
+// Returns false once the parameter has no options left
+//
+bool ConstraintSolver::strike( int param, int value )
+{
+    if( 0 == m_struck[ m_valueBegin[ param ] + value ]++ )
+    {
+        --m_options[ param ];
+    }
+    return( m_options[ param ] > 0 );
+}
+
+//
+//
+//
+void ConstraintSolver::restore( int param, int value )
+{
+    if( 0 == --m_struck[ m_valueBegin[ param ] + value ] )
+    {
+        ++m_options[ param ];
+    }
+}
+
+}
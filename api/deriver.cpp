@@ -13,28 +13,29 @@ namespace pictcore
 bool ExclusionDeriver::consistent( Exclusion &aa, Exclusion &bb )
 {
     // make sure the smaller one is in the outer loop
-    Exclusion *a;
-    Exclusion *b;
+    const vector<uint64_t>* a;
+    const vector<uint64_t>* b;
     if( aa.size() < bb.size() )
     {
-        a = &aa;
-        b = &bb;
+        a = &aa.GetKeys();
+        b = &bb.GetKeys();
     }
     else
     {
-        a = &bb;
-        b = &aa;
+        a = &bb.GetKeys();
+        b = &aa.GetKeys();
     }
 
-    Exclusion::iterator ib = b->begin();
-    for( Exclusion::iterator ia = a->begin(); ia != a->end(); ++ia )
+    uint32_t current = Exclusion::PackSequence( m_currentParam->GetSequence() );
+    vector<uint64_t>::const_iterator ib = b->begin();
+    for( vector<uint64_t>::const_iterator ia = a->begin(); ia != a->end(); ++ia )
     {
-        if( m_currentParam == ia->first )
+        if( current == Exclusion::KeySequence( *ia ) )
             continue;
 
         // move ib to see if we can find ia's parameter
-        // ia and ib are sorted by (i->first)->GetSequence() asc then i->second
-        while( ib != b->end() && ( ia->first )->GetSequence() > ( ib->first )->GetSequence() )
+        // keys are sorted by parameter sequence asc then value
+        while( ib != b->end() && Exclusion::KeySequence( *ia ) > Exclusion::KeySequence( *ib ) )
             ++ib;
 
         // end of b, return true
@@ -42,11 +43,11 @@ bool ExclusionDeriver::consistent( Exclusion &aa, Exclusion &bb )
             return true;
 
         // see if params match; if not, move on
-        if( ( ia->first )->GetSequence() != ( ib->first )->GetSequence() )
+        if( Exclusion::KeySequence( *ia ) != Exclusion::KeySequence( *ib ) )
             continue;
 
         // params match, what about values
-        if( ia->second != ib->second )
+        if( *ia != *ib )
             return false;
     }
     return true;
@@ -70,10 +71,13 @@ pair<ExclusionCollection::iterator, bool> ExclusionDeriver::AddExclusion( Exclus
     pair<ExclusionCollection::iterator, bool> result = m_exclusions.insert( excl );
     if( result.second )
     {
-        // later, we will attempt to find sorted lists so 
-        // the lookup structure should keep them sorted, too
-        sort( excl.lbegin(), excl.lend() );
-        m_lookup.insert( excl.GetList() );
+        // terms of an exclusion are kept sorted which is the order the lookup structure needs
+        m_lookup.insert( excl.begin(), excl.end() );
+
+        for( Exclusion::iterator it = excl.begin(); it != excl.end(); ++it )
+        {
+            m_postings[ *it ].push_back( result.first );
+        }
     }
 
     return result;
@@ -91,21 +95,31 @@ pair<ExclusionCollection::iterator, bool> ExclusionDeriver::AddExclusion( Exclus
 
 //
 // given an exclusion mark those in the collection which are now obsolete
+// an obsolete exclusion has all the terms of the given one so only the exclusions
+//    having its least common term need to be looked at
 //
 void ExclusionDeriver::markObsolete( ExclusionCollection::iterator ie )
 {
     // empty exclusions would obsolete all others; we don't want to remove those
     if( ie->empty() ) return;
 
-    for( ExclusionCollection::iterator im =  m_exclusions.begin();
-                                       im != m_exclusions.end(); 
-                                     ++im )
+    const ExclIterList* candidates = nullptr;
+    for( Exclusion::iterator it = ie->begin(); it != ie->end(); ++it )
     {
-        if( ( ie != im )
-         && ( !im->isDeleted() )
-         && contained( const_cast<Exclusion&> ( *ie ), const_cast<Exclusion&>( *im ) ) )
+        const ExclIterList& posting = m_postings[ *it ];
+        if( nullptr == candidates || posting.size() < candidates->size() )
         {
-            markDeleted( const_cast<Exclusion*>( &*im ) );
+            candidates = &posting;
+        }
+    }
+
+    for( ExclIterList::const_iterator im = candidates->begin(); im != candidates->end(); ++im )
+    {
+        if( ( ie != *im )
+         && ( !( *im )->isDeleted() )
+         && contained( const_cast<Exclusion&> ( *ie ), const_cast<Exclusion&>( **im ) ) )
+        {
+            markDeleted( *im );
         }
     }
 }
@@ -121,47 +135,35 @@ void AddExclusionParamBackPtrs( ExclusionCollection::iterator& excl )
     }
 }
 
-
 //
-// Clean the structure from the exclusions marked for deletion
+// Clean the structure from the exclusions marked for deletion, only they are
+//    unlinked from their parameters and dropped from the lookup structures
 //
 void ExclusionDeriver::peformDelete()
 {
-    if( !m_deletedAtLeastOne ) return;
+    if( m_deleted.empty() ) return;
 
-    //
-    // todo:
-    // This approach must be changed, we should be removing unnecessary links instead of recreating them
-    // For now however, the recreation seems safer and works fast enough
-    //
-
-    // actually delete all marked as deleted
-    ExclusionCollection::iterator ie = m_exclusions.begin();
-    while( ie != m_exclusions.end() )
+    for( ExclIterList::iterator id = m_deleted.begin(); id != m_deleted.end(); ++id )
     {
-        if( ie->isDeleted() )
+        ExclusionCollection::iterator ie = *id;
+        m_lookup.erase( ie->begin(), ie->end() );
+
+        for( Exclusion::iterator it = ie->begin(); it != ie->end(); ++it )
         {
-            Exclusion* pExcl = const_cast<Exclusion*>( &*ie );
-            m_lookup.erase( pExcl->GetList() );
-            ie = __map_erase( m_exclusions, ie );
-        }
-        else
-            ++ie;
-    }
+            ExclIterList& posting = m_postings[ *it ];
+            ExclIterList::iterator ip = find( posting.begin(), posting.end(), ie );
+            assert( ip != posting.end() );
+            *ip = posting.back();
+            posting.pop_back();
 
-    // recreate links to params
-    for( Parameter* param : m_parameters )
-    {
-        param->ClearExclusions();
-    }
+            it->first->UnlinkExclusion( ie );
+        }
 
-    for( ie = m_exclusions.begin(); ie != m_exclusions.end(); ++ie )
-    {
-        AddExclusionParamBackPtrs( ie );
+        m_exclusions.erase( ie );
     }
 
     // prepare for the next round
-    m_deletedAtLeastOne = false;
+    m_deleted.clear();
     DOUT( L"obsolete exclusions removed, now have: " << static_cast<int>( m_exclusions.size() ) << L"\n" );
 }
 
@@ -247,20 +249,12 @@ inline void ExclusionDeriver::buildExclusion( Exclusion& exclImplied, vector<Exc
 //
 // Given an exclusion, the function returns true if m_exclusions already has 
 //    this or a more general exclusion
-// This function makes a use of buckets to check only against those exclusions
-//    in m_exclusions which have at least one element of the given one
+// The lookup structure is searched for any exclusion whose terms are a subset
+//    of the given one's
 //
 inline bool ExclusionDeriver::alreadyInCollection( Exclusion &excl )
 {
-    // for all permutations
-    sort( excl.lbegin(), excl.lend() );
-    bool more = true;
-    while( more )
-    {
-        if( m_lookup.find_prefix( excl.GetList() ) ) return true;
-        more = next_permutation( excl.lbegin(), excl.lend() );
-    }
-    return false;
+    return( m_lookup.find_subset( excl.begin(), excl.end() ) );
 }
 
 //
@@ -283,8 +277,9 @@ inline bool ExclusionDeriver::alreadyInCollection( Exclusion &excl )
 //
 void ExclusionDeriver::DeriveExclusions()
 {
-    // For preview generation we don't invoke the core of the deriver at all
-    if( m_task->GetGenerationMode() != GenerationMode::Regular ) return;
+    // For preview generation we don't invoke the core of the deriver at all,
+    // with lazy constraints rows get checked against the exclusions as given
+    if( m_task->GetGenerationMode() != GenerationMode::Regular || m_task->GetLazyConstraints() ) return;
 
     DOUT( L"Exclusions:\n" );
     for( auto & exclusion : m_exclusions )
@@ -371,14 +366,15 @@ void ExclusionDeriver::DeriveExclusions()
 //
 //
 //
-void ExclusionDeriver::printLookupNode( trienode<Exclusion::_ExclusionVec::value_type> *node, int indent )
+void ExclusionDeriver::printLookupNode( const trienode<ExclusionTerm>& node, int indent )
 {
-    for( auto ii = node->children.begin(); ii != node->children.end(); ++ii )
-   {
+    for( int child = node.child; child != trienode<ExclusionTerm>::none; child = m_lookup.get_node( child ).sibling )
+    {
+        const trienode<ExclusionTerm>& current = m_lookup.get_node( child );
         for( int i = 0; i < indent; ++i )
             DOUT( L"  " );
-        DOUT( ii->first.first->GetName() << L": " << ii->first.second << L" [" << ii->second->value << L"]\n" );
-        printLookupNode( ii->second, indent + 1 );
+        DOUT( current.item.first->GetName() << L": " << current.item.second << L" [" << current.valid << L"]\n" );
+        printLookupNode( current, indent + 1 );
     }
 }
 
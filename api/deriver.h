@@ -7,6 +7,8 @@ namespace pictcore
 {
 
 typedef std::list<Exclusion*> ExclPtrList;
+typedef std::vector<ExclusionCollection::iterator> ExclIterList;
+typedef trie<ExclusionTerm, ExclusionTermCompare> ExclusionLookup;
 
 //
 //
@@ -29,12 +31,12 @@ private:
     bool consistent( Exclusion &a, Exclusion &b );
     bool alreadyInCollection( Exclusion &a );
 
-    void markDeleted ( Exclusion *excl ) { excl->markDeleted(); m_deletedAtLeastOne = true; }
+    void markDeleted ( ExclusionCollection::iterator ie ) { const_cast<Exclusion&>( *ie ).markDeleted(); m_deleted.push_back( ie ); }
     void markObsolete( ExclusionCollection::iterator ie );
     void peformDelete();
 
     void printLookup() { printLookupNode( m_lookup.get_root(), 0 ); }
-    void printLookupNode( trienode<Exclusion::_ExclusionVec::value_type>* node, int indent );
+    void printLookupNode( const trienode<ExclusionTerm>& node, int indent );
 
     ParamCollection                    m_parameters;
     ExclusionCollection                m_exclusions;
@@ -42,9 +44,13 @@ private:
     Task*                              m_task;
     std::vector<ExclPtrList>::iterator m_end;
     std::deque<Parameter* >            m_worklist;
-    trie<Exclusion::_ExclusionVec>     m_lookup;
+    ExclusionLookup                    m_lookup;
 
-    bool m_deletedAtLeastOne = false;
+    // exclusions having a given term, to find the ones a new exclusion makes obsolete
+    std::map<ExclusionTerm, ExclIterList, ExclusionTermCompare> m_postings;
+
+    // exclusions marked as deleted but still in the collection
+    ExclIterList m_deleted;
 };
 
 }
\ No newline at end of file
@@ -11,20 +11,22 @@ bool contained( Exclusion &a, Exclusion &b )
 {
     if( b.size() < a.size() ) return( false );
 
-    Exclusion::iterator ib = b.begin();
-    for( Exclusion::iterator ia = a.begin(); ia != a.end(); ++ia )
+    const std::vector<uint64_t>& ka = a.GetKeys();
+    const std::vector<uint64_t>& kb = b.GetKeys();
+    size_t ib = 0;
+    for( size_t ia = 0; ia < ka.size(); ++ia )
     {
-        // move ib until pointers of ia and ib match
-        while( ib != b.end() && ( ia->first )->GetSequence() != ( ib->first )->GetSequence() )
+        // move ib until parameters of ia and ib match
+        while( ib < kb.size() && Exclusion::KeySequence( ka[ ia ] ) != Exclusion::KeySequence( kb[ ib ] ) )
         {
             ++ib;
         }
 
-        // end of b, return true only if also end of a
-        if( ib == b.end() ) return ia == a.end();
+        // end of b, a has more terms
+        if( ib == kb.size() ) return false;
 
-        // pointers match, what about values
-        if( ia->second != ib->second ) return false;
+        // parameters match, what about values
+        if( ka[ ia ] != kb[ ib ] ) return false;
     }
     return true;
 }
@@ -58,25 +60,37 @@ int compareExclusionTerms( const ExclusionTerm& op1, const ExclusionTerm& op2 )
 //
 int compareExclusions(const Exclusion& op1, const Exclusion& op2)
 {
-    Exclusion::const_iterator i_op1 = op1.begin();
-    Exclusion::const_iterator i_op2 = op2.begin();
+    const std::vector<uint64_t>& k1 = op1.GetKeys();
+    const std::vector<uint64_t>& k2 = op2.GetKeys();
 
-    int comp = 0;
-    while( i_op1 != op1.end() &&
-           i_op2 != op2.end() )
+    size_t common = std::min( k1.size(), k2.size() );
+    for( size_t n = 0; n < common; ++n )
     {
-        comp = compareExclusionTerms( *i_op1, *i_op2 );
-        if( comp != 0 ) break;
-        ++i_op1;
-        ++i_op2;
+        if( k1[ n ] != k2[ n ] )
+            return k1[ n ] < k2[ n ] ? -1 : 1;
     }
-    if( comp != 0 )
-        return( comp );
+
+    if( k1.size() != k2.size() )
+        return k1.size() < k2.size() ? -1 : 1;
     else
-        if( op1.size() != op2.size() )
-            return op1.size() < op2.size() ? -1 : 1;
-        else
-            return 0;
+        return 0;
+}
+
+//
+// keeps terms and keys sorted, a term already present is not added again
+//
+std::pair<Exclusion::iterator, bool> Exclusion::insert( const ExclusionTerm& Term )
+{
+    uint64_t key = PackTerm( Term.first->GetSequence(), Term.second );
+    std::vector<uint64_t>::iterator pos = std::lower_bound( m_keys.begin(), m_keys.end(), key );
+    size_t index = pos - m_keys.begin();
+    if( pos != m_keys.end() && *pos == key )
+    {
+        return std::make_pair( m_terms.begin() + index, false );
+    }
+
+    m_keys.insert( pos, key );
+    return std::make_pair( m_terms.insert( m_terms.begin() + index, Term ), true );
 }
 
 //
@@ -85,7 +99,7 @@ int compareExclusions(const Exclusion& op1, const Exclusion& op2)
 size_t Exclusion::ResultParamCount() const
 {
     size_t count = 0;
-    for( auto & term : col )
+    for( auto & term : m_terms )
     {
         if( term.first->IsExpectedResultParam() )
         {
@@ -100,7 +114,7 @@ size_t Exclusion::ResultParamCount() const
 //
 void Exclusion::Print() const
 {
-    for( auto & term : col )
+    for( auto & term : m_terms )
         DOUT( ( term.first )->GetName() << L": " << term->second << L" " );
     DOUT( L"\n" );
 }
@@ -132,4 +146,101 @@ bool ExclIterCollectionPred::operator() ( const ExclusionCollection::iterator ex
     return( -1 == compareExclusions( *excl1, *excl2 ) );
 }
 
-}
\ No newline at end of file
+//
+// an exclusion binding a column to two different values can't match anything, it is
+//  kept out of the bitsets of all the values of that column
+//
+void ExclusionIndex::Build( const ExclusionCollection& exclusions )
+{
+    m_columns.clear();
+    m_words = ( exclusions.size() + 63 ) / 64;
+
+    std::map<int, size_t> columnIndex;
+    std::vector<std::vector<uint64_t>> constrained;
+    size_t bit = 0;
+    for( ExclusionCollection::const_iterator ie = exclusions.begin(); ie != exclusions.end(); ++ie, ++bit )
+    {
+        bool contradictory = false;
+        for( Exclusion::const_iterator it = ie->begin(); it != ie->end(); ++it )
+        {
+            Exclusion::const_iterator next = it;
+            if( ++next != ie->end() && next->first->GetSequence() == it->first->GetSequence() )
+            {
+                contradictory = true;
+            }
+        }
+
+        for( Exclusion::const_iterator it = ie->begin(); it != ie->end(); ++it )
+        {
+            std::pair<std::map<int, size_t>::iterator, bool> ic = columnIndex.insert( std::make_pair( it->first->GetSequence(), m_columns.size() ) );
+            if( ic.second )
+            {
+                m_columns.push_back( Column() );
+                m_columns.back().sequence = it->first->GetSequence();
+                constrained.push_back( std::vector<uint64_t>( m_words, 0 ) );
+            }
+
+            size_t col = ic.first->second;
+            constrained[ col ][ bit >> 6 ] |= uint64_t( 1 ) << ( bit & 63 );
+            if( contradictory ) continue;
+
+            std::vector<std::vector<uint64_t>>& byValue = m_columns[ col ].byValue;
+            if( it->second >= static_cast<int>( byValue.size() ) )
+            {
+                byValue.resize( it->second + 1, std::vector<uint64_t>( m_words, 0 ) );
+            }
+            byValue[ it->second ][ bit >> 6 ] |= uint64_t( 1 ) << ( bit & 63 );
+        }
+    }
+
+    // exclusions that leave a column alone stay in play whatever its value
+    m_lastMask = ( exclusions.size() & 63 ) ? ( uint64_t( 1 ) << ( exclusions.size() & 63 ) ) - 1 : ~uint64_t( 0 );
+    for( size_t col = 0; col < m_columns.size(); ++col )
+    {
+        Column& column = m_columns[ col ];
+        column.unconstrained.resize( m_words );
+        for( size_t w = 0; w < m_words; ++w )
+        {
+            column.unconstrained[ w ] = ~constrained[ col ][ w ];
+        }
+        column.unconstrained.back() &= m_lastMask;
+
+        for( size_t v = 0; v < column.byValue.size(); ++v )
+        {
+            for( size_t w = 0; w < m_words; ++w )
+            {
+                column.byValue[ v ][ w ] |= column.unconstrained[ w ];
+            }
+        }
+    }
+
+    m_match.resize( m_words );
+}
+
+//
+//
+//
+bool ExclusionIndex::Matches( const std::vector<int>& values )
+{
+    if( 0 == m_words ) return( false );
+
+    std::fill( m_match.begin(), m_match.end(), ~uint64_t( 0 ) );
+    m_match.back() = m_lastMask;
+
+    for( std::vector<Column>::const_iterator ic = m_columns.begin(); ic != m_columns.end(); ++ic )
+    {
+        int value = ic->sequence < static_cast<int>( values.size() ) ? values[ ic->sequence ] : -1;
+        const std::vector<uint64_t>& bits = ( value >= 0 && value < static_cast<int>( ic->byValue.size() ) ) ? ic->byValue[ value ] : ic->unconstrained;
+
+        uint64_t any = 0;
+        for( size_t w = 0; w < m_words; ++w )
+        {
+            m_match[ w ] &= bits[ w ];
+            any |= m_match[ w ];
+        }
+        if( 0 == any ) return( false );
+    }
+    return( true );
+}
+
+}
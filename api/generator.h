@@ -16,6 +16,14 @@
 #include <algorithm>
 #include <functional>
 #include <cassert>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <random>
+#include <unordered_map>
+#include <memory>
 
 //
 // Logging facility
@@ -125,7 +133,7 @@ typedef unsigned char TrackType;
 
 const TrackType OPEN = 0x00;
 const TrackType COVERED = 0x01;
-const TrackType EXCLUDED = 0xff;
+const TrackType EXCLUDED = 0x02;
 
 enum ComboStatus
 {
@@ -155,6 +163,7 @@ enum class ErrorType
     GenerationCancelled,
     TooManyRows,
     GenerationFailure,
+    TooRestrictive,     // no row satisfies the constraints, found only with lazy constraints
     OutOfMemory,
     Unknown
 };
@@ -177,7 +186,6 @@ private:
 //
 typedef std::vector<Combination *> ComboCollection;
 typedef std::vector<Parameter *>   ParamCollection;
-typedef std::list<size_t>          ParamResult;
 typedef std::pair<Parameter *, std::wstring> Value;
 
 //
@@ -191,9 +199,69 @@ void printRowSeed( RowSeed &seed );
 
 //
 // results
+// each column keeps its values in the narrowest unsigned type that holds all the values
+// of its parameter and the undefined marker; that is a byte for all but the largest ones
 //
-typedef std::vector<size_t>    ResultRow;
-typedef std::vector<ResultRow> ResultCollection;
+class ResultColumn
+{
+public:
+    static const unsigned int UndefinedValue = 0xFFFFFFFF;
+
+    explicit ResultColumn( int valueCount = 0 ) :
+        m_width( valueCount <= UINT8_MAX ? 1 : valueCount <= UINT16_MAX ? 2 : 4 ) {}
+
+    size_t Size() const
+    {
+        return( 1 == m_width ? m_narrow.size() : 2 == m_width ? m_medium.size() : m_wide.size() );
+    }
+
+    size_t Get( size_t row ) const
+    {
+        switch( m_width )
+        {
+        case 1:  return( UINT8_MAX  == m_narrow[ row ] ? UndefinedValue : m_narrow[ row ] );
+        case 2:  return( UINT16_MAX == m_medium[ row ] ? UndefinedValue : m_medium[ row ] );
+        default: return( m_wide[ row ] );
+        }
+    }
+
+    void Append( size_t value );
+    void Set( size_t row, size_t value );
+    void Truncate( size_t rows );
+    void KeepRows( const std::vector<size_t>& rows );
+    void Clear() { m_narrow.clear(); m_medium.clear(); m_wide.clear(); }
+
+    // hands the values over to a new column and leaves this one empty
+    ResultColumn Detach();
+
+private:
+    int                   m_width; // bytes per value
+    std::vector<uint8_t>  m_narrow;
+    std::vector<uint16_t> m_medium;
+    std::vector<uint32_t> m_wide;
+};
+
+//
+// the generated rows of a model, one column per parameter in parameter sequence order
+//
+class ResultTable
+{
+public:
+    size_t GetRowCount()    const { return( m_columns.empty() ? 0 : m_columns.front().Size() ); }
+    size_t GetColumnCount() const { return( m_columns.size() ); }
+
+    size_t Get( size_t row, size_t col ) const           { return( m_columns[ col ].Get( row ) ); }
+    void   Set( size_t row, size_t col, size_t value )   { m_columns[ col ].Set( row, value ); }
+
+    void AddColumn( ResultColumn&& column ) { m_columns.push_back( std::move( column ) ); }
+    void Truncate( size_t rows );
+    // drops all rows but the given ones, which must come in ascending order
+    void KeepRows( const std::vector<size_t>& rows );
+    void Clear() { m_columns.clear(); }
+
+private:
+    std::vector<ResultColumn> m_columns;
+};
 
 //
 // submodels
@@ -232,40 +300,30 @@ public:
 };
 
 //
-//
+// terms are kept in one array sorted the way ExclusionTermCompare orders them; next to each
+// is a key packing the parameter's sequence number and the value so exclusions can be
+// compared without going through the parameters
 //
 class Exclusion
 {
 public:
-    typedef std::set<ExclusionTerm, ExclusionTermCompare> _Exclusion;
-    typedef std::vector<ExclusionTerm>                    _ExclusionVec;
-    typedef _Exclusion::iterator                          iterator;
-    typedef _Exclusion::const_iterator                    const_iterator;
-    typedef _Exclusion::reference                         reference;
-    typedef _Exclusion::const_reference                   const_reference;
-    typedef _Exclusion::value_type                        value_type;
+    typedef std::vector<ExclusionTerm>     _Terms;
+    typedef _Terms::const_iterator         iterator;
+    typedef _Terms::const_iterator         const_iterator;
+    typedef _Terms::const_reference        reference;
+    typedef _Terms::const_reference        const_reference;
+    typedef _Terms::value_type             value_type;
 
     Exclusion() : m_deleted( false ) {}
 
-    iterator       begin()       { return( col.begin() ); }
-    iterator       end()         { return( col.end() ); }
-    const_iterator begin() const { return( col.begin() ); }
-    const_iterator end()   const { return( col.end() ); }
-    size_t size()  const         { return( col.size() ); }
-    bool   empty() const         { return( col.empty() ); }
+    const_iterator begin() const { return( m_terms.begin() ); }
+    const_iterator end()   const { return( m_terms.end() ); }
+    size_t size()  const         { return( m_terms.size() ); }
+    bool   empty() const         { return( m_terms.empty() ); }
 
-    // exclusion represented as a list, for next_permutation to work
-    _ExclusionVec::iterator lbegin() { return( vec.begin() ); }
-    _ExclusionVec::iterator lend()   { return( vec.end() ); }
-    _ExclusionVec &GetList()         { return( vec ); }
+    const std::vector<uint64_t>& GetKeys() const { return( m_keys ); }
 
-    std::pair<iterator, bool> insert( const ExclusionTerm& Term )
-    {
-        std::pair<iterator, bool> ret = col.insert( Term );
-        if( ret.second ) vec.push_back( Term );
-        assert( col.size() == vec.size() );
-        return ret;
-    }
+    std::pair<iterator, bool> insert( const ExclusionTerm& Term );
 
     // for inserter() to work we need two-param insert
     iterator insert( iterator, const ExclusionTerm& Term )
@@ -284,12 +342,200 @@ public:
 
     void Print() const;
 
+    // sequence number in the upper half, value in the lower, both signed so flipped to keep their order
+    static uint32_t PackSequence( int sequence ) { return( static_cast<uint32_t>( sequence ) ^ 0x80000000u ); }
+    static uint64_t PackTerm( int sequence, int value )
+    {
+        return( ( static_cast<uint64_t>( PackSequence( sequence ) ) << 32 ) | ( static_cast<uint32_t>( value ) ^ 0x80000000u ) );
+    }
+    static uint32_t KeySequence( uint64_t key ) { return( static_cast<uint32_t>( key >> 32 ) ); }
+
 private:
-    _Exclusion    col;
-    _ExclusionVec vec;
+    _Terms                m_terms;
+    std::vector<uint64_t> m_keys;
     bool m_deleted;
 };
 
+//
+// answers whether a row matches any of a collection of exclusions
+// every column mentioned by an exclusion keeps, for each of its values, a bitset of the exclusions
+//  that value leaves in play: those that constrain the column to it and those that don't constrain it;
+//  a row matches if any bit survives ANDing together the bitsets of its values
+//
+class ExclusionIndex
+{
+public:
+    ExclusionIndex() : m_words( 0 ), m_lastMask( 0 ) {}
+
+    void Build( const ExclusionCollection& exclusions );
+    bool Empty() const { return( 0 == m_words ); }
+
+    // values are indexed by parameter sequence, negative ones mark parameters missing from the row
+    bool Matches( const std::vector<int>& values );
+
+private:
+    struct Column
+    {
+        int sequence;
+        std::vector<std::vector<uint64_t>> byValue;
+        std::vector<uint64_t> unconstrained;
+    };
+
+    std::vector<Column>   m_columns;
+    std::vector<uint64_t> m_match;
+    size_t                m_words;
+    uint64_t              m_lastMask;
+};
+
+//
+// tells whether a partial row can be completed without matching any of a collection of exclusions;
+//  the exclusions are never combined into new ones, instead the unbound parameters are assigned
+//  one at a time, the one with the fewest values left first, and backtracked over on a dead end
+// an exclusion matched on all terms but one strikes the value of that one from its parameter's
+//  options, one with a term contradicted by an assigned value is out of play until unassigned
+//
+class ConstraintSolver
+{
+public:
+    ConstraintSolver() : m_boundable( 0 ), m_infeasible( false ) {}
+
+    // parameters of the context are only ever assigned by the solver, the parameters' bindings
+    // may belong to another model generated at the same time
+    void Build( const ParamCollection& params, const ParamCollection& context, const ExclusionCollection& exclusions );
+    void Clear();
+    bool IsActive() const { return( m_infeasible || !m_termBegin.empty() ); }
+
+    // the parameters' current bindings, if asked for, and the assumptions are taken as given;
+    // a completion found is returned in the order of the parameters the solver was built from,
+    // the context's following
+    bool CanComplete( const std::vector<ExclusionTerm>& assumptions, bool useBindings, std::vector<int>* solution = nullptr );
+
+    // -1 for parameters the solver wasn't built from
+    int IndexOf( const Parameter* param ) const;
+
+private:
+    struct Term
+    {
+        int param;
+        int value;
+    };
+    struct Occurrence
+    {
+        int exclusion;
+        int value;
+    };
+
+    ParamCollection                           m_params;
+    std::unordered_map<const Parameter*, int> m_index;
+    int                                       m_boundable;   // leading parameters whose bindings count
+    bool                                      m_infeasible;  // an empty exclusion rules out every row
+
+    // terms of exclusion e are m_terms[ m_termBegin[ e ] ] up to the beginning of the next one
+    std::vector<int>  m_termBegin;
+    std::vector<Term> m_terms;
+    std::vector<int>  m_matched;    // terms whose parameter is assigned their value
+    std::vector<int>  m_killed;     // terms whose parameter is assigned another value
+
+    std::vector<std::vector<Occurrence>> m_occurrences;  // per parameter, the exclusions it's in
+    std::vector<int> m_assigned;    // per parameter, the value or -1
+    std::vector<int> m_valueBegin;  // per parameter, where its values start in m_struck
+    std::vector<int> m_struck;      // per value, exclusions that strike it
+    std::vector<int> m_options;     // per parameter, values not struck
+    std::vector<int> m_inPlay;      // per parameter, exclusions in play it's in
+
+    std::vector<int> m_bindings;    // parameters assigned their bound values, in that order
+    bool             m_bindingsConsistent = true;
+
+    std::vector<int>* m_solution = nullptr;
+
+    int  termCount( int excl ) const { return( m_termBegin[ excl + 1 ] - m_termBegin[ excl ] ); }
+    bool isUnit( int excl ) const    { return( 0 == m_killed[ excl ] && m_matched[ excl ] == termCount( excl ) - 1 ); }
+    const Term& openTerm( int excl ) const;
+
+    bool strike ( int param, int value );
+    void restore( int param, int value );
+    bool assign  ( int param, int value );
+    void unassign( int param );
+    void releaseBindings();
+    bool search();
+};
+
+//
+// coverage state of all tuples of a combination packed into two bitplanes, one marking
+// open tuples and one marking excluded ones; covered tuples have neither bit set
+//
+class CoverageMap
+{
+public:
+    CoverageMap() : m_words( 0 ), m_bits( nullptr ) {}
+
+    // number of words the two planes of a map of the given size take up
+    static int WordCount( int size ) { return( 2 * ( ( size + 63 ) / 64 ) ); }
+
+    // the map does not own its storage, see ComboArena
+    void Attach( uint64_t* bits, int size, TrackType val );
+
+    bool IsOpen    ( int n ) const { return 0 != ( openPlane()[ n >> 6 ]     & bit( n ) ); }
+    bool IsExcluded( int n ) const { return 0 != ( excludedPlane()[ n >> 6 ] & bit( n ) ); }
+    TrackType Get  ( int n ) const { return IsOpen( n ) ? OPEN : IsExcluded( n ) ? EXCLUDED : COVERED; }
+    void Set       ( int n, TrackType val );
+
+    // number of open tuples among count consecutive ones starting at first
+    int CountOpen( int first, int count ) const;
+    // number of open tuples among the ones at the given positions
+    int CountOpen( const int* positions, int count ) const;
+    // excludes count consecutive tuples starting at first, returns how many of them were open
+    int ExcludeRun( int first, int count );
+    // copies the open plane, a bit for each tuple of the map
+    void CopyOpen( std::vector<uint64_t>& plane ) const { plane.assign( openPlane(), openPlane() + m_words ); }
+
+private:
+    typedef uint64_t Word;
+
+    int   m_words; // words per plane
+    Word* m_bits;  // the open plane followed by the excluded one
+
+    Word*       openPlane()           { return m_bits; }
+    const Word* openPlane()     const { return m_bits; }
+    Word*       excludedPlane()       { return m_bits + m_words; }
+    const Word* excludedPlane() const { return m_bits + m_words; }
+
+    static Word bit( int n ) { return Word( 1 ) << ( n & 63 ); }
+
+    CoverageMap( const CoverageMap& );
+    CoverageMap& operator=( const CoverageMap& );
+};
+
+//
+// division of non-negative ints by an invariant divisor as a multiplication and a shift
+//
+class Divisor
+{
+public:
+    Divisor() : m_divisor( 1 ), m_multiplier( 0 ), m_shift( 0 ) {}
+    explicit Divisor( int divisor );
+
+    int Get() const { return( m_divisor ); }
+    int Quotient( int n ) const
+    {
+        return( static_cast<int>( ( static_cast<uint64_t>( n ) * m_multiplier ) >> m_shift ) );
+    }
+
+    // replaces n with the quotient and returns the remainder
+    int DivMod( int& n ) const
+    {
+        int quotient  = Quotient( n );
+        int remainder = n - quotient * m_divisor;
+        n = quotient;
+        return( remainder );
+    }
+
+private:
+    int      m_divisor;
+    uint64_t m_multiplier;
+    int      m_shift;
+};
+
 //
 // combination
 //
@@ -298,62 +544,111 @@ const unsigned int UNDEFINED_ID = 0;
 class Combination
 {
 public:
-    Combination( Model* model );
-    ~Combination();
+    // tuple n of a combination holds the value ( n / strides[ i ] ) % radices[ i ] of its i-th parameter
+    Combination( Model* model, Parameter** params, const int* strides, const Divisor* radices, int paramCount );
 
-    static void ResetId() { m_lastUsedId = UNDEFINED_ID; }
     unsigned int GetId()  { return m_id; }
 
     void WireModel( Model* model ) { m_model = model; }
 
-    void PushParameter( Parameter* param ) { m_params.push_back( param ); }
-    void PopParameter()                    { m_params.pop_back(); }
     Parameter& operator[]( int N ) const   { return *( m_params[ N ] ); }
 
     void InitBinding() { m_boundCount = 0; }
     int  Bind( int val, WorkList& worklist );
     int  AddBinding();
     int  GetBoundCount() const { return m_boundCount; }
-    bool IsFullyBound()  const { return m_boundCount == static_cast<int>(m_params.size()); }
+    bool IsFullyBound()  const { return m_boundCount == m_paramCount; }
 
     void        SetOpen   ( int n );
-    bool        IsOpen    ( int n ) const { return OPEN     == m_bitvec[ n ]; }
-    bool        IsExcluded( int n ) const { return EXCLUDED == m_bitvec[ n ]; }
-    ComboStatus Feasible  ( int n );
-    int         Feasible();
+    bool        IsOpen    ( int n ) const { return m_coverage.IsOpen( n ); }
+    bool        IsExcluded( int n ) const { return m_coverage.IsExcluded( n ); }
 
     void ApplyExclusion( Exclusion& excl );
-    bool ViolatesExclusion();
-
-    ParamCollection& GetParameters() { return m_params; }
-    int  GetParameterCount() const { return static_cast<int>( m_params.size() ); }
+    // excludes the tuples matching an exclusion whose terms bind the parameters at the given positions
+    // of this combination; returns how many of them were open, the open count is left to DropOpen
+    int  ExcludeTuples( const Exclusion& excl, const int* positions );
+    void DropOpen( int count ) { if( count > 0 ) updateOpenCount( -count ); }
+
+    Parameter* const* GetParameterBegin() const { return m_params; }
+    Parameter* const* GetParameterEnd()   const { return m_params + m_paramCount; }
+    int  GetParameterCount() const { return m_paramCount; }
+    int  GetStride( int n )  const { return m_strides[ n ]; }
+    const Divisor& GetRadix( int n ) const { return m_radices[ n ]; }
     int  GetOpenCount()      const { return m_openCount; }
     int  GetRange()          const { return m_range; }
-    void SetMapSize( int n, TrackType val = 0 );
-    int  Weight( int vak );
+    const CoverageMap& GetCoverage() const { return m_coverage; }
+    Combination* GetQueueNext()      const { return m_queueNext; }
+    void SetMapSize( int n, uint64_t* bits, TrackType val );
+    int  Weight( int value ) const;
     void Print();
 
-    void Assign( Combination &Combo )
-    {
-        m_params     = Combo.GetParameters();
-        m_range      = Combo.GetRange();
-        m_openCount  = Combo.GetOpenCount();
-        m_boundCount = Combo.GetBoundCount();
-    }
+    // position among the combinations of a RowLayout
+    void SetLayoutIndex( int index ) { m_layoutIndex = index; }
+    int  GetLayoutIndex() const      { return m_layoutIndex; }
 
 private:
-    static unsigned int m_lastUsedId; // static source of identifiers
-    unsigned int        m_id;         // unique identifier of this instance
+    unsigned int    m_id;         // unique within the task, see Task::NewCombinationId
 
-    ParamCollection m_params;
-    unsigned char*  m_bitvec;
+    Parameter**     m_params;     // the parameter list, its tables and the coverage
+    const int*      m_strides;    // map all live in the model's ComboArena
+    const Divisor*  m_radices;
+    int             m_paramCount;
+    CoverageMap     m_coverage;
     int             m_range;
     int             m_openCount;
     int             m_boundCount;
+    int             m_layoutIndex = 0;
 
     Model* m_model;
 
-    void applyExclusion( Exclusion& excl, int index, ParamCollection::iterator pos );
+    // links of the open count bucket this combination sits in, see ComboQueue
+    friend class ComboQueue;
+    Combination* m_queuePrev;
+    Combination* m_queueNext;
+    bool         m_queued;
+
+    void updateOpenCount( int delta );
+};
+
+//
+// storage of all the combinations of a model: headers, parameter lists and coverage maps
+// are each carved out of a slab of their own so that a sweep over the combinations walks
+// memory in the order they were created in; everything is released at once by Clear()
+//
+class ComboArena
+{
+public:
+    ComboArena() {}
+    ~ComboArena() { Clear(); }
+
+    // a combination of the given parameters with all its tuples set to val
+    Combination* NewCombination( Model* model, const ParamCollection& params, TrackType val );
+    void Clear();
+
+private:
+    //
+    // bump allocator over a list of chunks of growing size
+    //
+    class Slab
+    {
+    public:
+        Slab() : m_next( nullptr ), m_end( nullptr ) {}
+
+        void* Allocate( size_t size, size_t align );
+        void  Release();
+
+    private:
+        std::vector<char*> m_chunks;
+        char*              m_next;
+        char*              m_end;
+    };
+
+    Slab m_headers;
+    Slab m_paramLists;
+    Slab m_bitmaps;
+
+    ComboArena( const ComboArena& );
+    ComboArena& operator=( const ComboArena& );
 };
 
 // Combinations pointers in ComboCollection should be sorted by id and not by memory location
@@ -366,6 +661,36 @@ public:
     }
 };
 
+//
+// bucket queue of combinations keyed by their open count
+// lets gcd find the combination with the most uncovered tuples without sweeping all of them
+//
+class ComboQueue
+{
+public:
+    ComboQueue() : m_top( 0 ) {}
+
+    void Build( ComboCollection& combos );
+    void Clear();
+
+    // to be called whenever the open count of a queued combination changes
+    void Move( Combination* combo, int oldCount );
+
+    // read-only walk over the buckets, see RowPicker
+    int          GetTop() const { return( m_top ); }
+    Combination* GetBucket( int count ) const
+    {
+        return( count < static_cast<int>( m_buckets.size() ) ? m_buckets[ count ] : nullptr );
+    }
+
+private:
+    std::vector<Combination*> m_buckets; // heads of the per-count lists
+    int                       m_top;     // the highest count with a combination in it
+
+    void link  ( Combination* combo, int count );
+    void unlink( Combination* combo, int count );
+};
+
 //
 // parameter
 //
@@ -375,14 +700,14 @@ public:
     Parameter( int order, int sequence, int valueCount, std::wstring name, bool expectedResultParam ) :
         m_name( name ), m_order( order ), m_sequence( sequence ), m_valueCount( valueCount ),
         m_expResultParam( expectedResultParam ), m_bound( false ),
-        m_pending( false ), m_valueWeights( 0 ), m_avgExclusionSize( 0 )
+        m_pending( false ), m_result( valueCount ), m_valueWeights( 0 ), m_avgExclusionSize( 0 )
     {
          // result params must have order = 1
         if ( m_expResultParam ) m_order = 1;
     }
     virtual ~Parameter() {}
 
-    static const unsigned int UndefinedValue = 0xFFFFFFFF;
+    static const unsigned int UndefinedValue = ResultColumn::UndefinedValue;
 
     void SetOrder( int Order ) { m_order = Order; }
     void SetWeights( std::vector<int> Weights );
@@ -392,6 +717,7 @@ public:
 
     int GetOrder() const { return m_order; }
 
+    bool HasWeights() const { return( !m_valueWeights.empty() ); }
     int GetWeight( int n ) const
     {
         if( 0 <= n && n < static_cast<int>( m_valueWeights.size() ) )
@@ -401,7 +727,7 @@ public:
     }
     int GetSequence()        const { return m_sequence; }
     int GetValueCount()      const { return static_cast<int>( m_valueCount ); }
-    int GetTempResultCount() const { return static_cast<int>( m_result.size() ); }
+    int GetTempResultCount() const { return static_cast<int>( m_result.Size() ); }
     int GetExclusionCount()  const { return static_cast<int>( m_exclusions.size() ); }
     void  ClearExclusions() { m_avgExclusionSize = 0; m_exclusions.clear(); }
     float GetAverageExclusionSize() const { return m_avgExclusionSize; }
@@ -421,14 +747,14 @@ public:
     void MarkPending()     { m_pending = true; }
     bool IsPending() const { return m_pending; }
 
-    int PickValue();
+    int PickValue( Model& model );
 
     void LinkCombination( Combination* combo ) { m_combinations.push_back( combo ); }
     
     // remember to sort by Id, not with default sorting pred (by memory address)
     void SortCombinations() { sort( m_combinations.begin(), m_combinations.end(), CombinationPtrSortPred() ); }
-    ComboCollection::const_iterator GetCombinationBegin() { return m_combinations.begin(); }
-    ComboCollection::const_iterator GetCombinationEnd()   { return m_combinations.end(); }
+    ComboCollection::const_iterator GetCombinationBegin() const { return m_combinations.begin(); }
+    ComboCollection::const_iterator GetCombinationEnd()   const { return m_combinations.end(); }
 
     void LinkExclusion( ExclusionCollection::iterator iter )
     {
@@ -441,18 +767,21 @@ public:
     {
         size_t erased = m_exclusions.erase( Iter );
         assert( 1 == erased );
+        if( 0 == erased ) return;
+        m_avgExclusionSize = m_exclusions.empty() ? 0 : ( m_avgExclusionSize * (float) ( m_exclusions.size() + 1 ) - (float) Iter->size() ) / (float) m_exclusions.size();
     }
 
-    void GetFirst()   { m_resultIter = m_result.begin(); }
-    size_t GetNext()  { return *m_resultIter++; }
-    size_t GetLast()  { return  m_currentValue; }
-    ParamResult& GetTempResults() { return m_result; }
+    size_t GetLast() const { return  m_currentValue; }
+    ResultColumn& GetTempResults() { return m_result; }
 
     virtual Model*           GetModel()      { return nullptr; }
     virtual ParamCollection* GetComponents() { return nullptr; }
 
     void CleanUp();
 
+    void SetLayoutIndex( int index ) { m_layoutIndex = index; }
+    int  GetLayoutIndex() const      { return m_layoutIndex; }
+
 protected:
     std::wstring m_name;
 
@@ -469,14 +798,15 @@ private:
     ComboCollection       m_combinations;  // combinations this parameter participates in
     ExclIterCollection    m_exclusions;    // exclusions referring to this parameter
 
-    ParamResult::iterator m_resultIter;
-    ParamResult           m_result;
+    ResultColumn          m_result;
 
     std::vector<int>      m_valueWeights;
 
     Task*  m_task = nullptr;
 
     float  m_avgExclusionSize;
+
+    int    m_layoutIndex = 0;   // position among the parameters of a RowLayout
 };
 
 //
@@ -494,6 +824,125 @@ private:
     Model* m_model;
 };
 
+//
+// parameters and combinations of a model numbered for row builders to keep their binding state in
+// arrays; the numbers live on the parameters and combinations themselves, see GetLayoutIndex
+//
+class RowLayout
+{
+public:
+    void Build( ParamCollection& params, ComboCollection& combos, ComboQueue& queue, bool strict );
+
+private:
+    friend class RowBuilder;
+
+    ParamCollection   m_params;
+    ComboCollection   m_combos;
+    const ComboQueue* m_queue = nullptr;
+    bool              m_strict = true; // a value must always be found
+};
+
+//
+// builds a row the way Model::gcd does but on a binding state of its own, only reading
+// the coverage maps, so that several candidate rows can be built at the same time
+// it is the binding state of the RowPicker making the choices, see ModelBindings
+//
+class RowBuilder
+{
+public:
+    RowBuilder( const RowLayout& layout );
+
+    // returns false if the row ran into a dead end
+    bool Build( unsigned int seed, int* workbuf );
+
+    // number of open tuples the row covers and its values, indexed like the layout parameters
+    int                     GetScore()  const { return( m_score ); }
+    const std::vector<int>& GetValues() const { return( m_values ); }
+
+    int Value( const Parameter* param ) const       { return( m_values[ param->GetLayoutIndex() ] ); }
+    int BoundCount( const Combination* combo ) const { return( m_boundCounts[ combo->GetLayoutIndex() ] ); }
+    int Random( size_t n ) { return( static_cast<int>( m_random() % n ) ); }
+
+private:
+    const RowLayout*        m_layout;
+    std::vector<int>        m_values;      // -1 while a parameter is unbound
+    std::vector<char>       m_pending;
+    std::vector<int>        m_boundCounts; // per combination
+    std::deque<Parameter*>  m_worklist;
+    std::minstd_rand        m_random;
+    int                     m_unbound;
+    int                     m_score;
+
+    void bindCombination( const Combination& combo, int key );
+    void bind( Parameter* param, int value );
+};
+
+//
+// a small pool of worker threads spreading independent pieces of work
+// the calling thread takes part in the work so a pool of one thread runs everything inline
+//
+class WorkerPool
+{
+public:
+    typedef std::function<void( int item, int slot )> Job;
+
+    WorkerPool() : m_threadCount( 1 ), m_stopping( false ), m_batch( 0 ),
+                   m_job( nullptr ), m_itemCount( 0 ), m_nextItem( 0 ), m_busy( 0 ) {}
+    ~WorkerPool() { Stop(); }
+
+    void Start( int threadCount );
+    void Stop();
+    int  GetThreadCount() const { return( m_threadCount ); }
+
+    // calls job( item, slot ) for every item below count and returns once all are done
+    // slot identifies the thread running the item so jobs can use per-thread workspaces
+    // jobs must not throw
+    void Run( int count, const Job& job );
+
+private:
+    int                      m_threadCount;
+    std::vector<std::thread> m_threads;
+
+    std::mutex               m_mutex;
+    std::condition_variable  m_wake;
+    std::condition_variable  m_done;
+    bool                     m_stopping;
+    unsigned int             m_batch;     // bumped whenever a new job is posted
+    const Job*               m_job;
+    int                      m_itemCount;
+    std::atomic<int>         m_nextItem;
+    int                      m_busy;      // helper threads still working on the current job
+
+    void worker( int slot );
+    void work( int slot );
+
+    WorkerPool( const WorkerPool& );
+    WorkerPool& operator=( const WorkerPool& );
+};
+
+//
+// receives the rows of a model one at a time, as soon as generation completes them
+// the values are indexes into the parameters, in the order the parameters were defined
+//
+class RowSink
+{
+public:
+    virtual ~RowSink() {}
+    virtual void WriteRow( const std::vector<size_t>& values ) = 0;
+};
+
+//
+// checks rows against the constraints a task's exclusions were made from, without going through
+// the exclusions; the values are indexed by parameter sequence and negative ones mark parameters
+// the row doesn't have (yet), a row violates the constraints if it matches any of the exclusions
+//
+class RowPredicate
+{
+public:
+    virtual ~RowPredicate() {}
+    virtual bool Violates( const std::vector<int>& values ) const = 0;
+};
+
 //
 //
 //
@@ -539,12 +988,8 @@ public:
 
     void SetOrder     ( int order )    { m_order = order; }
     void SetMaxRows   ( long maxRows ) { m_maxRows = maxRows; }
-    void SetRandomSeed( long seed )
-    {
-        m_randomSeed = seed;
-        srand( m_randomSeed );
-        for( auto & submodel : m_submodels ) submodel->SetRandomSeed( m_randomSeed );
-    }
+    void SetRowSink   ( RowSink* sink ) { m_rowSink = sink; }
+    void SetRandomSeed( long seed );
 
     void WireTask( Task* task )
     {
@@ -555,11 +1000,31 @@ public:
 
     Task* GetTask() { return( m_task ); }
 
+    // the random stream restarts from the model's seed every time the model is generated
+    unsigned int Random()           { return( static_cast<unsigned int>( m_random() ) ); }
+    int          Random( size_t n ) { return( static_cast<int>( m_random() % n ) ); }
+
+    // each worker thread gets a workspace of its own
+    int* GetWorkbuf( int slot = 0 ) { return( m_workbuf.data() + slot * m_workbufSize ); }
+
+    // a model generated alongside its siblings keeps to the thread it runs on
+    WorkerPool& GetWorkers();
+    void SetConcurrent( bool concurrent ) { m_concurrent = concurrent; }
+
+    // splits the submodels into groups sharing no parameters; a submodel only comes in a later
+    // group than all the ones before it it shares parameters with
+    void GetSubmodelWaves( std::vector<std::vector<Model*>>& waves );
+
+    ComboQueue& GetComboQueue() { return( m_comboQueue ); }
+
+    // active only while a model with lazy constraints is generated
+    ConstraintSolver& GetSolver() { return( m_solver ); }
+
     std::wstring&         GetId()         { return m_id; }
     SubmodelCollection&   GetSubmodels()  { return m_submodels; }
     ExclusionCollection&  GetExclusions() { return m_exclusions; }
     RowSeedCollection&    GetRowSeeds()   { return( m_rowSeeds ); }
-    ResultCollection&     GetResults()    { return m_results; }
+    ResultTable&          GetResults()    { return m_results; }
     ParamCollection&      GetParameters() { return m_parameters; }
 
     void GetAllParameters( ParamCollection& params )
@@ -584,13 +1049,17 @@ public:
         return count;
     }
 
+    // rows of models made of submodels or with expected results are only final when generation ends,
+    // so are the rows of compacted results
+    bool CanStreamRows();
+
     int  GetOrder()      { return m_order; }
     long GetRandomSeed() { return( m_randomSeed ); }
 
     long GetTotalCombinationsCount()     { return static_cast<long>( m_totalCombinations ); }
     long GetRemainingCombinationsCount() { return static_cast<long>( m_remainingCombinations ); }
     int  GetSubmodelCount()              { return static_cast<int> ( m_submodels.size() ); }
-    int  GetResultCount()                { return static_cast<int> ( m_results.size() ); }
+    int  GetResultCount()                { return static_cast<int> ( m_results.GetRowCount() ); }
 
     int GlobalZerosCount;
 
@@ -601,7 +1070,13 @@ private:
     SubmodelCollection     m_submodels;
     RowSeedCollection      m_rowSeeds;
     std::deque<Parameter*> m_worklist;
-    ResultCollection       m_results;
+    ResultTable            m_results;
+    ComboQueue             m_comboQueue;
+    ComboArena             m_comboArena;
+    ExclusionIndex         m_exclusionIndex;
+    std::vector<int>       m_rowValues;
+    std::vector<int>       m_predicateValues;
+    ConstraintSolver       m_solver;
 
     std::wstring m_id;
 
@@ -615,7 +1090,17 @@ private:
     long         m_totalCombinations;
     long         m_remainingCombinations;
 
-    Task* m_task;
+    Task* m_task = nullptr;
+
+    RowSink* m_rowSink = nullptr;
+
+    std::minstd_rand m_random;
+    std::vector<int> m_workbuf;
+    int              m_workbufSize = 0;
+    bool             m_concurrent  = false;
+    WorkerPool       m_ownWorkers;  // never started, runs everything inline
+
+    void allocWorkbuf( int size );
 
     void generateMixedOrder();           // generates mixed-order (the most generic)
     void generateFixedOrder();           // generates fixed, n-order
@@ -625,24 +1110,31 @@ private:
 
     void resolvePseudoParams();          // helper that handles submodels
     void fixRowSeeds();                  // helper that cleans up seeding rows
+    bool bindBestCandidate( std::vector<RowBuilder>& builders, WorkList& worklist );
+    void compactRows( ComboCollection& vecCombo, std::vector<std::vector<uint64_t>>& required,
+                      size_t fixedRows, std::vector<size_t>& keep );
     void gcd( ComboCollection& ComboCol ); // generation entry point
 
     void choose( ParamCollection::iterator first,
                  ParamCollection::iterator last,
                  int order, int realOrder,
-                 Combination& baseCombo, ComboCollection& vecCombo );
+                 ParamCollection& baseParams, ComboCollection& vecCombo );
 
     void processExclusions( ComboCollection& comboCol );
+    void excludeIncompletableTuples( ComboCollection& comboCol );
+    int  drawCompletable( Combination* combo, std::vector<int>& candidates, bool weighted );
+    void intersectCombinations( const ParamCollection& params, ComboCollection& intersection );
     bool excludeConflictingParamValues();
     bool mapExclusionsToPseudoParameters();
     void mapRowSeedsToPseudoParameters();
     void deriveSubmodelExclusions();
-    bool rowViolatesExclusion( ResultRow& row );
+    bool rowViolatesExclusion( size_t row );
     bool rowViolatesExclusion( Exclusion& row );
+    bool rowValuesViolateExclusion();
 
     void markUndefinedValuesInResultParams();
 
-    Exclusion generateRandomRow();
+    bool generateRandomRow( Exclusion& row );
 };
 
 //
@@ -657,12 +1149,6 @@ public:
     // this has to be called right before generation starts
     void PrepareForGeneration();
 
-    void AllocWorkbuf( int Size );
-
-    int* GetWorkbuf() { return( m_workbuf ); }
-
-    void DeallocWorkbuf();
-
     void SetRootModel( Model* model )
     {
         m_rootModel = model;
@@ -694,11 +1180,45 @@ public:
     void SetMaxRandomTries( size_t max ) { m_maxRandomTries = max; }
     size_t GetMaxRandomTries() { return( m_maxRandomTries ); }
 
-    ResultCollection& GetResults() { return m_rootModel->GetResults(); }
+    // how many rows are built for each one kept, see RowBuilder
+    void SetCandidateCount( int count ) { m_candidateCount = count; }
+    int  GetCandidateCount() const      { return( m_candidateCount ); }
+
+    // drop rows whose every tuple some other row covers too
+    void SetCompactResults( bool compact ) { m_compactResults = compact; }
+    bool GetCompactResults() const         { return( m_compactResults ); }
+
+    // in regular mode, leave the exclusions as given and check rows against them as they are built,
+    // see ConstraintSolver; no implied exclusions get derived
+    void SetLazyConstraints( bool lazy ) { m_lazyConstraints = lazy; }
+    bool GetLazyConstraints() const      { return( m_lazyConstraints ); }
+
+    // the exclusions given are already derived, by a task of the same model for instance;
+    // PrepareForGeneration only hands them out to the models then
+    void SetExclusionsDerived( bool derived ) { m_exclusionsDerived = derived; }
+
+    // in the preview and approximate modes rows are checked one by one, with a predicate set it
+    // stands in for all of the task's exclusions; it only ever sees the actual parameters
+    void SetRowPredicate( const RowPredicate* predicate ) { m_rowPredicate = predicate; }
+    const RowPredicate* GetRowPredicate() const           { return( m_rowPredicate ); }
+
+    // how many threads may share the work; results do not depend on it
+    void SetThreadCount( int count ) { m_workers.Start( count ); }
+    int  GetThreadCount() const      { return( m_workers.GetThreadCount() ); }
+    WorkerPool& GetWorkers()         { return( m_workers ); }
+
+    ResultTable& GetResults() { return m_rootModel->GetResults(); }
+
+    unsigned int NewCombinationId() { return( ++m_lastCombinationId ); }
+
+    // generates models sharing no parameters at the same time on the worker threads,
+    // see Model::GetSubmodelWaves
+    void GenerateModels( std::vector<Model*>& models );
 
     // these two functions are used by C-style API which only returns one row at a time
     void ResetResultFetching();
-    ResultCollection::iterator GetNextResultRow();
+    // returns the index of the row or the row count once all were fetched
+    size_t GetNextResultRow();
 
 private:
     Model*              m_rootModel;
@@ -716,12 +1236,19 @@ private:
     bool findParamInSubtree( Parameter* param, Model* root );
     void deriveExclusions();
 
-    // a global workspace shared by multiple objects
-    int* m_workbuf = nullptr;
+    WorkerPool m_workers;
+    int        m_candidateCount = 1;
+    bool       m_compactResults = false;
+    bool       m_lazyConstraints = false;
+    bool       m_exclusionsDerived = false;
+
+    const RowPredicate* m_rowPredicate = nullptr;
+
+    std::atomic<unsigned int> m_lastCombinationId{ UNDEFINED_ID };
 
-    // result row pointer allows C-style API to implement GetNextResultRow function
+    // result row index allows C-style API to implement GetNextResultRow function
     // i.e. get one result row at a time
-    ResultCollection::iterator m_currentResultRow;
+    size_t m_currentResultRow = 0;
 };
 
 //
@@ -1,5 +1,6 @@
 #include "generator.h"
 #include "deriver.h"
+#include "rowpicker.h"
 using namespace std;
 
 namespace pictcore
@@ -28,7 +29,7 @@ void Model::choose( ParamCollection::iterator first,     // the iterators apply
                     ParamCollection::iterator last,
                     int                       order,     // number of items to choose in the range from first to last
                     int                       realOrder, // real order of this combination
-                    Combination&              baseCombo,
+                    ParamCollection&          baseParams,
                     ComboCollection&          vecCombo ) // where to put result vector
 {
     assert( order >= 0 && order <= realOrder );
@@ -37,25 +38,15 @@ void Model::choose( ParamCollection::iterator first,     // the iterators apply
     if( 0 == order )
     {
         // add the current combination to the result vector
-        Combination *combo = new Combination( this );
-        combo->Assign( baseCombo );
+        // its bit vector is sized and all its zeros are added to the global zero count
+        Combination *combo = m_comboArena.NewCombination( this, baseParams, OPEN );
         vecCombo.push_back( combo );
 
-        // add the combination to all the parameters
-        // set up its bit vector
-        // initialize the zero count
-        // add to the global zero count Combination::GlobalZero
-        int size = 1;
+        // link all parameters in the combination to this combination
         for( int n = 0; n < combo->GetParameterCount(); ++n )
         {
-            // link all parameters in the combination to this combination
             ( *combo )[ n ].LinkCombination( combo );
-            // determine size of bit vector
-            size *= ( *combo )[ n ].GetValueCount();
         }
-
-        // set size of combination's bit vector
-        combo->SetMapSize( size );
         return;
     }
 
@@ -67,12 +58,120 @@ void Model::choose( ParamCollection::iterator first,     // the iterators apply
     while( distance( first, last ) >= order && ( ( *( --last ) )->GetOrder() == order || order != realOrder ) )
     {
         // add the parameter to the combination
-        baseCombo.PushParameter( *last );
+        baseParams.push_back( *last );
 
         // recurse over remaining elements
-        choose( first, last, order - 1, realOrder, baseCombo, vecCombo );
-        baseCombo.PopParameter();
+        choose( first, last, order - 1, realOrder, baseParams, vecCombo );
+        baseParams.pop_back();
+    }
+}
+
+//
+// Builds candidate rows on the task's worker threads and binds the one covering the most open
+// tuples; each candidate draws from a random stream seeded up front so the outcome does not
+// depend on the number of threads
+// Returns false if no candidate could be completed, the row then has to be built the regular way
+//
+bool Model::bindBestCandidate( vector<RowBuilder>& builders, WorkList& worklist )
+{
+    vector<unsigned int> seeds( builders.size() );
+    vector<char> built( builders.size() );
+    for( auto & seed : seeds )
+    {
+        seed = Random();
+    }
+
+    GetWorkers().Run( static_cast<int>( builders.size() ), [ & ]( int item, int slot ) {
+        built[ item ] = builders[ item ].Build( seeds[ item ], GetWorkbuf( slot ) );
+    } );
+
+    RowBuilder* best = nullptr;
+    for( size_t n = 0; n < builders.size(); ++n )
+    {
+        if( built[ n ] && ( nullptr == best || builders[ n ].GetScore() > best->GetScore() ) )
+        {
+            best = &builders[ n ];
+        }
     }
+    if( nullptr == best ) return( false );
+
+    DOUT( L"Best candidate row covers " << best->GetScore() << L" tuples.\n" );
+
+    // binding the whole row at once, nothing should go on the work list
+    for( auto param : m_parameters )
+    {
+        param->MarkPending();
+    }
+    const vector<int>& values = best->GetValues();
+    for( size_t n = 0; n < m_parameters.size(); ++n )
+    {
+        m_parameters[ n ]->Bind( values[ n ], worklist );
+    }
+    return( true );
+}
+
+//
+// Drops rows whose every required tuple is covered by some other row that stays. Tuple counts
+// are taken for all combinations at once on the worker threads, then rows are visited from the
+// last one since those built late tend to add the least. The first fixedRows rows always stay.
+//
+void Model::compactRows( ComboCollection& vecCombo, vector<vector<uint64_t>>& required,
+                         size_t fixedRows, vector<size_t>& keep )
+{
+    size_t rowCount = static_cast<size_t>( m_parameters.front()->GetTempResultCount() );
+
+    auto rowKey = [ &vecCombo ]( int cidx, size_t row ) {
+        Combination* combo = vecCombo[ cidx ];
+        int key = 0;
+        for( int n = 0; n < combo->GetParameterCount(); ++n )
+        {
+            key += static_cast<int>( combo->GetParameterBegin()[ n ]->GetTempResults().Get( row ) ) * combo->GetStride( n );
+        }
+        return( key );
+    };
+    auto isRequired = [ &required ]( int cidx, int key ) {
+        return( 0 != ( ( required[ cidx ][ key >> 6 ] >> ( key & 63 ) ) & 1 ) );
+    };
+
+    vector<vector<int>> counts( vecCombo.size() );
+    GetWorkers().Run( static_cast<int>( vecCombo.size() ), [ & ]( int cidx, int ) {
+        counts[ cidx ].assign( vecCombo[ cidx ]->GetRange(), 0 );
+        for( size_t row = 0; row < rowCount; ++row )
+        {
+            int key = rowKey( cidx, row );
+            if( isRequired( cidx, key ) ) ++counts[ cidx ][ key ];
+        }
+    } );
+
+    vector<char> dropped( rowCount, 0 );
+    vector<int> keys( vecCombo.size() );
+    for( size_t row = rowCount; row-- > fixedRows; )
+    {
+        bool redundant = true;
+        for( int cidx = 0; cidx < static_cast<int>( vecCombo.size() ); ++cidx )
+        {
+            keys[ cidx ] = rowKey( cidx, row );
+            if( isRequired( cidx, keys[ cidx ] ) && counts[ cidx ][ keys[ cidx ] ] < 2 )
+            {
+                redundant = false;
+                break;
+            }
+        }
+        if( !redundant ) continue;
+
+        for( int cidx = 0; cidx < static_cast<int>( vecCombo.size() ); ++cidx )
+        {
+            if( isRequired( cidx, keys[ cidx ] ) ) --counts[ cidx ][ keys[ cidx ] ];
+        }
+        dropped[ row ] = 1;
+    }
+
+    keep.clear();
+    for( size_t row = 0; row < rowCount; ++row )
+    {
+        if( !dropped[ row ] ) keep.push_back( row );
+    }
+    DOUT( L"Compaction dropped " << rowCount - keep.size() << L" rows.\n" );
 }
 
 //
@@ -93,8 +192,48 @@ void Model::gcd( ComboCollection &vecCombo )
 {
     if( m_parameters.empty() ) return;
 
+    m_random.seed( static_cast<minstd_rand::result_type>( m_randomSeed ) );
+
     processExclusions( vecCombo );
 
+    // with lazy constraints nothing was derived from the exclusions, the solver has to tell
+    //  which tuples and which values of a row being built they rule out together
+    if( m_task->GetLazyConstraints() && m_task->GetGenerationMode() == GenerationMode::Regular )
+    {
+        // rows of a submodel have to fit with the rest of the task's parameters too, with derived
+        //  exclusions that'd be taken care of by those falling entirely within the submodel;
+        //  the other parameters are taken from the exclusions as other models may be generated
+        //  concurrently and reorder their own parameter lists
+        ParamCollection context;
+        ExclusionCollection* exclusions = &m_exclusions;
+        if( m_task->GetRootModel() != this && m_submodels.empty() )
+        {
+            exclusions = &m_task->GetExclusions();
+            set<Parameter*> seen;
+            for( auto & excl : *exclusions )
+            {
+                for( auto & term : excl )
+                {
+                    if( seen.insert( term.first ).second ) context.push_back( term.first );
+                }
+            }
+        }
+        m_solver.Build( m_parameters, context, *exclusions );
+        if( m_solver.IsActive() )
+        {
+            // nothing got derived that would have found this out earlier
+            if( !m_solver.CanComplete( vector<ExclusionTerm>(), false ) )
+            {
+                throw GenerationError( __FILE__, __LINE__, ErrorType::TooRestrictive );
+            }
+            excludeIncompletableTuples( vecCombo );
+        }
+    }
+    else
+    {
+        m_solver.Clear();
+    }
+
     fixRowSeeds();
 
     int maxRange = -1;
@@ -107,10 +246,61 @@ void Model::gcd( ComboCollection &vecCombo )
     }
     if( maxRange <= 0 ) return;
 
-    GetTask()->AllocWorkbuf( maxRange );
+    allocWorkbuf( maxRange );
+
+    m_comboQueue.Build( vecCombo );
+
+    // in the candidates mode each row is the best of several built at the same time;
+    //  candidate rows know nothing of the solver so lazy constraints build rows one at a time
+    bool lazy = m_solver.IsActive();
+    ModelBindings bindings( *this );
+    RowPicker<ModelBindings> picker( bindings );
+    RowLayout layout;
+    vector<RowBuilder> builders;
+    if( m_task->GetCandidateCount() > 1 && m_task->GetGenerationMode() != GenerationMode::Approximate && !lazy )
+    {
+        layout.Build( m_parameters, vecCombo, m_comboQueue, m_task->GetGenerationMode() != GenerationMode::Preview );
+        builders.assign( m_task->GetCandidateCount(), RowBuilder( layout ) );
+    }
+
+    // rows of a flat model are final as soon as they are built so they can be handed out right away;
+    // the parameters' own result columns then never hold more than the row being built
+    bool streaming = nullptr != m_rowSink && CanStreamRows();
+    bool preview   = m_task->GetGenerationMode() == GenerationMode::Preview;
+    long maxRows   = GenerationType::Flat == m_generationType || GenerationType::Random == m_generationType ? m_maxRows : 0;
+    long rowsWritten = 0;
+    ParamCollection sequence;
+    vector<size_t> row;
+
+    // rows of these two modes get checked against the exclusions one by one, unless the task
+    //  has a predicate to check them with
+    if( ( preview || m_task->GetGenerationMode() == GenerationMode::Approximate ) && nullptr == m_task->GetRowPredicate() )
+    {
+        m_exclusionIndex.Build( m_exclusions );
+    }
+
+    if( streaming )
+    {
+        sequence = m_parameters;
+        sort( sequence.begin(), sequence.end(), LessThanBySequence() );
+        row.resize( sequence.size() );
+    }
 
     m_totalCombinations = GlobalZerosCount;
 
+    // the tuples rows have to cover, compaction keeps at least one row for each
+    bool compact = m_task->GetCompactResults() && !streaming && !preview;
+    vector<vector<uint64_t>> required;
+    size_t seededRows = 0;
+    if( compact )
+    {
+        required.resize( vecCombo.size() );
+        for( size_t cidx = 0; cidx < vecCombo.size(); ++cidx )
+        {
+            vecCombo[ cidx ]->GetCoverage().CopyOpen( required[ cidx ] );
+        }
+    }
+
     // main loop: repeat until we've found all required parameter value combinations
     while( GlobalZerosCount > 0 )
     {
@@ -119,10 +309,8 @@ void Model::gcd( ComboCollection &vecCombo )
         if( GetTask()->AbortGeneration() )
         {
             // tear down all the combinations
-            for( ComboCollection::iterator i = vecCombo.begin(); i != vecCombo.end(); ++i )
-            {
-                delete *i;
-            }
+            m_comboQueue.Clear();
+            m_comboArena.Clear();
 
             throw GenerationError( __FILE__, __LINE__, ErrorType::GenerationCancelled );
         }
@@ -146,14 +334,23 @@ void Model::gcd( ComboCollection &vecCombo )
 
         // do we have unused seed data?
         // if yes: bind those values, make sure combinations get marked, zero counts (including global) updated
-        if( !m_rowSeeds.empty() )
+        bool seeded = !m_rowSeeds.empty();
+        if( seeded )
         {
             RowSeed &rowSeed = m_rowSeeds.front();
             for( RowSeed::iterator ir = rowSeed.begin(); ir != rowSeed.end(); ++ir )
             {
                 ( ir->first )->MarkPending();
             }
-            for( RowSeed::iterator ir = rowSeed.begin(); ir != rowSeed.end(); ++ir )
+
+            // the seed is ordered by address, binding in the order the parameters were defined
+            //  keeps the rows from depending on where the parameters happen to be allocated
+            vector<RowSeedTerm> terms( rowSeed.begin(), rowSeed.end() );
+            sort( terms.begin(), terms.end(), []( const RowSeedTerm& term1, const RowSeedTerm& term2 )
+            {
+                return( term1.first->GetSequence() < term2.first->GetSequence() );
+            } );
+            for( vector<RowSeedTerm>::iterator ir = terms.begin(); ir != terms.end(); ++ir )
             {
                 // find the parameter in the collection
                 Parameter* param = ir->first;
@@ -165,6 +362,7 @@ void Model::gcd( ComboCollection &vecCombo )
                 }
             }
             m_rowSeeds.pop_front();
+            ++seededRows;
         }
 
         for( int cidx = 0; cidx < static_cast<int>( vecCombo.size() ); ++cidx )
@@ -180,13 +378,12 @@ void Model::gcd( ComboCollection &vecCombo )
             
             CandidateRow candidateRow;
 
+            // rows are valid as drawn, a retry is only needed when the drawing runs into a dead end
             size_t attempt = 0;
             bool stop = false;
             while( 1 )
             {
-                candidateRow = generateRandomRow();
-
-                if( !rowViolatesExclusion( candidateRow ) )
+                if( generateRandomRow( candidateRow ) )
                     break;
 
                 if( ++attempt >= m_task->GetMaxRandomTries() )
@@ -216,6 +413,12 @@ void Model::gcd( ComboCollection &vecCombo )
         // non Approximate aka regular mode
         else
         {
+            // rows continuing a seed are always built the regular way
+            if( !seeded && !builders.empty() && bindBestCandidate( builders, worklist ) )
+            {
+                unbound = 0;
+            }
+
             // loop to build one result vector: while some parameters remain unbound
             while( unbound > 0 )
             {
@@ -224,64 +427,15 @@ void Model::gcd( ComboCollection &vecCombo )
                     DOUT( L"Empty worklist: finding a seed combination.\n" );
                     // pick a zero from feasible combination with the most zeros, bind corresponding values
                     int maxZeros = 0;
-                    int maxMatch = 0;
-                    int ties     = 0;
-                    int choice   = -1;
-                    for( int cidx = 0; cidx < static_cast<int>( vecCombo.size() ); ++cidx )
-                    {
-                        if( !vecCombo[ cidx ]->IsFullyBound() )
-                        {
-                            int open  = 0;
-                            int match = 0;
-
-                            // Make sure there's a feasible value set
-                            for( int vidx = 0; vidx < vecCombo[ cidx ]->GetRange(); ++vidx )
-                            {
-                                ComboStatus status = vecCombo[ cidx ]->Feasible( vidx );
-                                if( ComboStatus::Open == status )
-                                {
-                                    ++open;
-                                }
-                                else if( ComboStatus::CoveredMatch == status )
-                                {
-                                    ++match;
-                                }
-                            }
+                    Combination* choice = picker.PickMostOpen( m_comboQueue, maxZeros, GetWorkbuf() );
 
-                            // if combo has the most zeros
-                            if( open > maxZeros )
-                            {
-                                choice   = cidx;
-                                ties     = 1;
-                                maxZeros = open;
-                            }
-                            // if number of zeros ties up with some previous choice, pick randomly
-                            else if( open == maxZeros
-                                 &&  maxZeros > 0
-                                 &&  !( rand() % ++ties ) )
-                            {
-                                choice = cidx;
-                            }
-                            // no zeros were found anywhere yet, pick the best matching one
-                            else if( maxZeros == 0
-                                 &&  match > maxMatch )
-                            {
-                                choice = cidx;
-                                ties = 1;
-                                maxMatch = match;
-                            }
-                            // if there's a tie in match, pick randomly
-                            else if( maxZeros == 0
-                                 &&  match > 0
-                                 &&  match == maxMatch
-                                 &&  !( rand() % ++ties ) )
-                            {
-                                choice = cidx;
-                            }
-                        }
-                    } // for cidx
-                    assert( choice != -1 );
-                    if( -1 == choice )
+                    // no zeros were found anywhere, pick the best matching one
+                    if( nullptr == choice )
+                    {
+                        choice = picker.PickBestMatch( vecCombo );
+                    }
+                    assert( nullptr != choice );
+                    if( nullptr == choice )
                     {
                         throw GenerationError( __FILE__, __LINE__, ErrorType::GenerationFailure );
                     }
@@ -289,52 +443,66 @@ void Model::gcd( ComboCollection &vecCombo )
                     // no combo had any uncovered combinations in it
                     if( 0 == maxZeros )
                     {
-                        int totalWeight = 0;
-                        int bestValue   = -1;
-                        // For each non-excluded value in the bitvec, find total weight
-                        for( int vidx = 0; vidx < vecCombo[ choice ]->GetRange(); ++vidx )
+                        int bestValue = -1;
+                        if( lazy )
                         {
-                            if( ComboStatus::Excluded != vecCombo[ choice ]->Feasible( vidx ) )
+                            // with lazy constraints the row may not be completable with some of them
+                            vector<int> candidates;
+                            for( int vidx = 0; vidx < choice->GetRange(); ++vidx )
                             {
-                                // Pick a value using weighted random choice
-                                int weight = vecCombo[ choice ]->Weight( vidx );
-                                totalWeight += weight;
-                                if( rand() % totalWeight < weight )
+                                if( ComboStatus::Excluded != picker.GetStatus( *choice, vidx ) )
                                 {
-                                    bestValue = vidx;
+                                    candidates.push_back( vidx );
                                 }
                             }
+                            bestValue = drawCompletable( choice, candidates, true );
+                        }
+                        else
+                        {
+                            // Pick a value using weighted random choice
+                            bestValue = picker.PickWeightedTuple( *choice );
                         }
-                        unbound -= vecCombo[ choice ]->Bind( bestValue, worklist );
+                        unbound -= choice->Bind( bestValue, worklist );
                     }
                     else
                     {
                         // OK, we picked a combination, now pick a value set
-                        vector<int> candidates;
-                        for( int vidx = 0; vidx < vecCombo[ choice ]->GetRange(); ++vidx )
+                        int zeroVal = -1;
+                        if( lazy )
                         {
-                            if( ComboStatus::Open == vecCombo[ choice ]->Feasible( vidx ) )
+                            vector<int> candidates;
+                            for( int vidx = 0; vidx < choice->GetRange(); ++vidx )
                             {
-                                candidates.push_back( vidx );
+                                if( ComboStatus::Open == picker.GetStatus( *choice, vidx ) )
+                                {
+                                    candidates.push_back( vidx );
+                                }
                             }
-                        }
-#if (0)
-                        if (candidates.empty())
-                        {
-                            for (int vidx = 0; vidx < vecCombo[choice]->GetRange(); ++vidx)
+
+                            // the row may not be completable with any of the open tuples, it always
+                            //  is with some tuple or the row wouldn't have come this far
+                            zeroVal = drawCompletable( choice, candidates, false );
+                            for( int vidx = 0; zeroVal < 0 && vidx < choice->GetRange(); ++vidx )
                             {
-                                if (CoveredMatch == vecCombo[choice]->Feasible(vidx))
+                                if( ComboStatus::CoveredMatch == picker.GetStatus( *choice, vidx ) )
                                 {
-                                    candidates.push_back(vidx);
+                                    candidates.push_back( vidx );
                                 }
                             }
+                            if( zeroVal < 0 ) zeroVal = drawCompletable( choice, candidates, false );
+                        }
+                        else
+                        {
+                            zeroVal = picker.PickOpenTuple( *choice );
+                            assert( zeroVal >= 0 );
+                            if( zeroVal < 0 )
+                            {
+                                throw GenerationError( __FILE__, __LINE__, ErrorType::GenerationFailure );
+                            }
                         }
-#endif
-                        assert( !candidates.empty() );
-                        int zeroVal = candidates[ rand() % candidates.size() ];
                         DOUT( L"Chose value " << zeroVal << L", unbound count was " << unbound << L".\n" );
                         // Bind the values corresponding to the zero
-                        unbound -= vecCombo[ choice ]->Bind( zeroVal, worklist );
+                        unbound -= choice->Bind( zeroVal, worklist );
                         DOUT( L"After combo bind, unbound count was " << unbound << L".\n" );
                     }
                 }
@@ -345,19 +513,61 @@ void Model::gcd( ComboCollection &vecCombo )
                     Parameter *param = worklist.GetItem();
                     assert( !param->GetBoundCount() );
                     DOUT( L"From worklist " );
-                    param->Bind( param->PickValue(), worklist );
+                    param->Bind( param->PickValue( *this ), worklist );
                     --unbound;
                 }
             } // end: unbound > 0
         } // end: non-Approximate
+
+        if( streaming )
+        {
+            Exclusion boundRow;
+            for( size_t n = 0; n < sequence.size(); ++n )
+            {
+                row[ n ] = sequence[ n ]->GetLast();
+                sequence[ n ]->GetTempResults().Clear();
+                if( preview ) boundRow.insert( make_pair( sequence[ n ], static_cast<int>( row[ n ] ) ) );
+            }
+
+            // preview may produce rows that violate exclusions, those are never written
+            if( !preview || !rowViolatesExclusion( boundRow ) )
+            {
+                m_rowSink->WriteRow( row );
+                ++rowsWritten;
+            }
+
+            // the rest would only be cut off
+            if( maxRows > 0 && rowsWritten >= maxRows ) break;
+        }
     }
 
     m_remainingCombinations = GlobalZerosCount;
 
+    // rows made of seeds stay no matter what
+    vector<size_t> keptRows;
+    if( compact )
+    {
+        compactRows( vecCombo, required, seededRows, keptRows );
+    }
+
     // tear down all the combinations
-    for( ComboCollection::iterator i = vecCombo.begin(); i != vecCombo.end(); ++i )
+    m_comboQueue.Clear();
+    m_comboArena.Clear();
+    m_solver.Clear();
+
+    // remove violating cases, it's needed for preview mode of
+    //   generation as in that mode, the results contain some invalid cases;
+    //   rows are checked while pseudoparameters, which exclusions may refer to, are still around
+    vector<size_t> validRows;
+    if( preview && !m_parameters.empty() )
     {
-        delete *i;
+        for( size_t row = 0; row < static_cast<size_t>( m_parameters.front()->GetTempResultCount() ); ++row )
+        {
+            if( !rowViolatesExclusion( row ) )
+            {
+                validRows.push_back( row );
+            }
+        }
     }
 
     resolvePseudoParams();
@@ -365,40 +575,22 @@ void Model::gcd( ComboCollection &vecCombo )
     // put parameter vector back into original sequence
     sort( m_parameters.begin(), m_parameters.end(), LessThanBySequence() );
 
-    // move results from parameters into this Model
-    size_t results = 0;
+    // move results from parameters into this Model, a column at a time
+    assert( 0 == m_results.GetColumnCount() );
     for( ParamCollection::iterator ip = m_parameters.begin(); ip != m_parameters.end(); ++ip )
     {
-        ( *ip )->GetFirst();
-        if( results )
-        {
-            assert( ( *ip )->GetTempResultCount() == results );
-        }
-        else
-        {
-            results = ( *ip )->GetTempResultCount();
-        }
+        assert( ip == m_parameters.begin() || ( *ip )->GetTempResultCount() == static_cast<int>( m_results.GetRowCount() ) );
+        m_results.AddColumn( ( *ip )->GetTempResults().Detach() );
     }
-    for( size_t n = 0; n < results; ++n )
-    {
-        ResultRow resultRow;
-        for( ParamCollection::iterator ip = m_parameters.begin(); ip != m_parameters.end(); ++ip )
-        {
-            resultRow.push_back( ( *ip )->GetNext() );
-        }
 
-        // remove violating cases, it's needed for preview mode of
-        //   generation as in that mode, m_result contains some invalid cases
-        bool violatesExclusion = false;
+    if( compact )
+    {
+        m_results.KeepRows( keptRows );
+    }
 
-        if( GetTask()->GetGenerationMode() == GenerationMode::Preview )
-        {
-            violatesExclusion = rowViolatesExclusion( resultRow );
-        }
-        if( !violatesExclusion )
-        {
-            m_results.push_back( resultRow );
-        }
+    if( preview )
+    {
+        m_results.KeepRows( validRows );
     }
 
     for( ParamCollection::iterator ip = m_parameters.begin(); ip != m_parameters.end(); ++ip )
@@ -436,7 +628,7 @@ void Model::markUndefinedValuesInResultParams()
     map< Parameter*, vector< set< int > > > excludedResultValues;
 
     vector< set< int > > emptyVector;
-    emptyVector.resize( m_results.size() );
+    emptyVector.resize( m_results.GetRowCount() );
     for( ParamCollection::iterator ip = m_parameters.begin(); ip != m_parameters.end(); ++ip )
     {
         if( ( *ip )->IsExpectedResultParam() )
@@ -452,9 +644,7 @@ void Model::markUndefinedValuesInResultParams()
     //     for each result param of i_excl (i_param)
     //       remove value of i_param from corresponding set in structure
 
-    int row_idx = 0;
-    for( ResultCollection::iterator i_row = m_results.begin();
-                                    i_row != m_results.end(); ++i_row, ++row_idx )
+    for( size_t row_idx = 0; row_idx < m_results.GetRowCount(); ++row_idx )
     {
         for( ExclusionCollection::iterator i_excl = m_exclusions.begin();
                                            i_excl != m_exclusions.end(); ++i_excl )
@@ -469,7 +659,7 @@ void Model::markUndefinedValuesInResultParams()
             {
                 // TODO: when result params are suported check modl/modl021.txt doesn't break here
                 if( !i_term->first->IsExpectedResultParam()
-                &&  static_cast<int>(i_row->at( i_term->first->GetSequence() )) != i_term->second )
+                &&  static_cast<int>(m_results.Get( row_idx, i_term->first->GetSequence() )) != i_term->second )
                 {
                     matches = false;
                     break;
@@ -522,7 +712,7 @@ void Model::markUndefinedValuesInResultParams()
             // all values have to be excluded except for 1
             if( static_cast<int>(ip->second[ row ].size()) != ip->first->GetValueCount() - 1 )
             {
-                m_results[ row ][ col ] = Parameter::UndefinedValue;
+                m_results.Set( row, col, Parameter::UndefinedValue );
             }
         }
     }
@@ -555,10 +745,11 @@ void Model::resolvePseudoParams()
                 if( p != m_parameters.end() ) continue;
 
                 // map values using results in param
-                for( ParamResult::iterator ir = param->GetTempResults().begin(); ir != param->GetTempResults().end(); ++ir )
+                const ResultColumn& pseudoResults = param->GetTempResults();
+                for( size_t row = 0; row < pseudoResults.Size(); ++row )
                 {
-                    size_t nMappedValue = param->GetModel()->GetResults()[ ( *ir ) ][ nComp ];
-                    ( *comps )[ nComp ]->GetTempResults().push_back( nMappedValue );
+                    size_t nMappedValue = param->GetModel()->GetResults().Get( pseudoResults.Get( row ), nComp );
+                    ( *comps )[ nComp ]->GetTempResults().Append( nMappedValue );
                 }
                 // add to the model
                 AddParameter( ( *comps )[ nComp ] );
@@ -632,8 +823,8 @@ bool Model::excludeConflictingParamValues()
                     {
                         // if r1.p1 != r2.p2
                         //     add r1, r2 to exlusions  
-                        if( s1->GetModel()->GetResults()[ v1 ][ np1 ] !=
-                            s2->GetModel()->GetResults()[ v2 ][ np2 ] )
+                        if( s1->GetModel()->GetResults().Get( v1, np1 ) !=
+                            s2->GetModel()->GetResults().Get( v2, np2 ) )
                         {
                             Exclusion excl;
                             excl.insert( make_pair( s1, v1 ) );
@@ -658,6 +849,96 @@ bool Model::excludeConflictingParamValues()
     return( ret );
 }
 
+namespace
+{
+
+//
+// mixes the position of a submodel into the seed of its parent so siblings
+// of the same shape don't all come out the same
+//
+long deriveSeed( long seed, size_t index )
+{
+    uint64_t z = static_cast<uint64_t>( seed ) + ( index + 1 ) * 0x9E3779B97F4A7C15ULL;
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+    z =   z ^ ( z >> 31 );
+    return( static_cast<long>( z & 0x7FFFFFFF ) );
+}
+
+}
+
+//
+//
+//
+bool Model::CanStreamRows()
+{
+    return( m_submodels.empty() && 0 == GetResultParameterCount() && !m_task->GetCompactResults() );
+}
+
+//
+// submodels get seeds derived from this one so each can be generated on its own
+//
+void Model::SetRandomSeed( long seed )
+{
+    m_randomSeed = seed;
+
+    size_t index = 0;
+    for( auto & submodel : m_submodels )
+    {
+        submodel->SetRandomSeed( deriveSeed( m_randomSeed, index++ ) );
+    }
+}
+
+//
+//
+//
+WorkerPool& Model::GetWorkers()
+{
+    return( m_concurrent ? m_ownWorkers : m_task->GetWorkers() );
+}
+
+//
+//
+//
+void Model::allocWorkbuf( int size )
+{
+    m_workbuf.assign( static_cast<size_t>( size ) * GetWorkers().GetThreadCount(), 0 );
+    m_workbufSize = size;
+}
+
+//
+//
+//
+void Model::GetSubmodelWaves( vector<vector<Model*>>& waves )
+{
+    waves.clear();
+
+    vector<set<Parameter*>> params;
+    vector<size_t>          waveOf;
+    for( auto & submodel : m_submodels )
+    {
+        size_t wave = 0;
+        for( size_t prev = 0; prev < params.size(); ++prev )
+        {
+            if( waveOf[ prev ] < wave ) continue;
+            for( auto & param : submodel->GetParameters() )
+            {
+                if( params[ prev ].find( param ) != params[ prev ].end() )
+                {
+                    wave = waveOf[ prev ] + 1;
+                    break;
+                }
+            }
+        }
+
+        params.push_back( set<Parameter*>( submodel->GetParameters().begin(), submodel->GetParameters().end() ) );
+        waveOf.push_back( wave );
+
+        if( wave == waves.size() ) waves.push_back( vector<Model*>() );
+        waves[ wave ].push_back( submodel );
+    }
+}
+
 //
 // 
 //
@@ -670,7 +951,7 @@ void Model::Generate()
         DOUT( ( *ip )->GetName() << L", order: " << ( *ip )->GetOrder() << endl );
 
     // Clear previous results before generating new ones
-    m_results.clear();
+    m_results.Clear();
 
     switch( m_generationType )
     {
@@ -731,29 +1012,25 @@ void Model::GenerateVirtualRoot()
     ComboCollection vecCombo;
     for( SubmodelCollection::iterator i = m_submodels.begin(); i != m_submodels.end(); ++i )
     {
-        Combination *combo = new Combination( this );
+        // init all combinations to satisfied, don't count any zeros
+        Combination *combo = m_comboArena.NewCombination( this, ( *i )->GetParameters(), COVERED );
         vecCombo.push_back( combo );
-        int size = 1;
         for( ParamCollection::iterator ip = ( *i )->GetParameters().begin(); ip != ( *i )->GetParameters().end(); ++ip )
         {
             ( *ip )->LinkCombination( combo );
-            combo->PushParameter( *ip );
-            size *= ( *ip )->GetValueCount();
         }
 
-        // init all combinations to satisfied, don't count any zeros
-        combo->SetMapSize( size, COVERED );
         // for each result row
         for( int ridx = 0; ridx < ( *i )->GetResultCount(); ++ridx )
         {
             size_t index = 0;
             // calculate index to combination corresponding to this sub-model output row
-            const ResultRow& results = ( *i )->GetResults()[ ridx ];
+            const ResultTable& results = ( *i )->GetResults();
             int cidx = 0;
             for( ParamCollection::iterator ip = ( *i )->GetParameters().begin(); ip != ( *i )->GetParameters().end(); ++ip )
             {
                 index *= ( *ip )->GetValueCount();
-                index += results[ cidx++ ];
+                index += results.Get( ridx, cidx++ );
             }
             // make this index a target to generate
             combo->SetOpen( (int) index );
@@ -801,8 +1078,8 @@ void Model::generateMixedOrder()
         // Get the range of each order
         while( lastOrder != m_parameters.end() && ( *lastOrder )->GetOrder() == order )
             ++lastOrder;
-        Combination baseCombo( this );
-        choose( m_parameters.begin(), lastOrder, order, order, baseCombo, vecCombo );
+        ParamCollection baseParams;
+        choose( m_parameters.begin(), lastOrder, order, order, baseParams, vecCombo );
     }
 
     gcd( vecCombo );
@@ -836,8 +1113,8 @@ void Model::generateFixedOrder()
 
     mapRowSeedsToPseudoParameters();
 
-    Combination baseCombo( this );
-    choose( m_parameters.begin(), m_parameters.end(), m_order, m_order, baseCombo, vecCombo );
+    ParamCollection baseParams;
+    choose( m_parameters.begin(), m_parameters.end(), m_order, m_order, baseParams, vecCombo );
     gcd( vecCombo );
 }
 
@@ -881,12 +1158,12 @@ void Model::generateFull()
 
     mapRowSeedsToPseudoParameters();
 
-    Combination baseCombo( this );
+    ParamCollection baseParams;
     choose( m_parameters.begin(),
             m_parameters.end(),
             static_cast<int>( m_parameters.size() ),
             static_cast<int>( m_parameters.size() ),
-            baseCombo, vecCombo );
+            baseParams, vecCombo );
     gcd( vecCombo );
 }
 
@@ -919,12 +1196,12 @@ void Model::generateRandom()
 
     mapRowSeedsToPseudoParameters();
 
-    Combination baseCombo( this );
-    choose( m_parameters.begin(), m_parameters.end(), 1, 1, baseCombo, vecCombo );
+    ParamCollection baseParams;
+    choose( m_parameters.begin(), m_parameters.end(), 1, 1, baseParams, vecCombo );
     gcd( vecCombo );
-    if( m_maxRows > 0 && m_maxRows < static_cast<long>( m_results.size() ) )
+    if( m_maxRows > 0 && m_maxRows < static_cast<long>( m_results.GetRowCount() ) )
     {
-        m_results.erase( m_results.begin() + m_maxRows, m_results.end() );
+        m_results.Truncate( m_maxRows );
     }
 }
 
@@ -968,44 +1245,57 @@ void Model::generateFlat()
     generateFixedOrder();
 
     // trim the output if necessary
-    if( m_maxRows > 0 && m_maxRows < static_cast<long>( m_results.size() ) )
+    if( m_maxRows > 0 && m_maxRows < static_cast<long>( m_results.GetRowCount() ) )
     {
-        m_results.erase( m_results.begin() + m_maxRows, m_results.end() );
+        m_results.Truncate( m_maxRows );
     }
 }
 
 //
+// draws the values one parameter at a time from those that don't complete an exclusion
+// returns false if some parameter runs out of values
 //
-//
-Exclusion Model::generateRandomRow()
+bool Model::generateRandomRow( Exclusion& row )
 {
-    Exclusion row;
+    row = Exclusion();
+    m_rowValues.assign( m_rowValues.size(), -1 );
+
+    vector<int> allowed;
     for( ParamCollection::iterator ip = m_parameters.begin(); ip != m_parameters.end(); ++ip )
     {
-        int sum = 0;
-        for( int i = 0; i < ( *ip )->GetValueCount(); ++i )
+        int sequence = ( *ip )->GetSequence();
+        if( sequence >= static_cast<int>( m_rowValues.size() ) )
         {
-            sum += ( *ip )->GetWeight( i );
+            m_rowValues.resize( sequence + 1, -1 );
         }
-        int idx = rand() % sum;
 
-        int n;
-        int val = 0;
-        for( n = 0; n < ( *ip )->GetValueCount(); ++n )
+        // drop the values that would complete an exclusion with the values drawn so far
+        allowed.clear();
+        int sum = 0;
+        for( int i = 0; i < ( *ip )->GetValueCount(); ++i )
         {
-            if( val < idx )
+            m_rowValues[ sequence ] = i;
+            if( !rowValuesViolateExclusion() )
             {
-                val += ( *ip )->GetWeight( n );
-            }
-            else
-            {
-                break;
+                allowed.push_back( i );
+                sum += ( *ip )->GetWeight( i );
             }
         }
+        if( allowed.empty() ) return( false );
+
+        // weighted random choice among the remaining values
+        int idx = Random( sum );
+        size_t n = 0;
+        for( int val = ( *ip )->GetWeight( allowed[ 0 ] ); val <= idx; val += ( *ip )->GetWeight( allowed[ n ] ) )
+        {
+            ++n;
+        }
+        int value = allowed[ n ];
 
-        row.insert( make_pair( *ip, n ) );
+        m_rowValues[ sequence ] = value;
+        row.insert( make_pair( *ip, value ) );
     }
-    return( row );
+    return( true );
 }
 
 
@@ -1064,7 +1354,7 @@ bool Model::mapExclusionsToPseudoParameters()
                                 break;
                             }
                             int nParam = static_cast<int>( distance( comps->begin(), ip ) );
-                            int nRealVal = static_cast<int>(param->GetModel()->GetResults()[ vidx ][ nParam ]);
+                            int nRealVal = static_cast<int>(param->GetModel()->GetResults().Get( vidx, nParam ));
                             if( nRealVal != irel->second )
                             {
                                 break;
@@ -1150,95 +1440,249 @@ void Model::processExclusions( ComboCollection& vecCombo )
         ( *ip )->SortCombinations();
     }
 
+    // exclusions over the same parameters share their target combinations so the
+    //  intersection is formed once per such group, in the order the groups first appear
+    vector<ParamCollection> groupParams;
+    vector<vector<const Exclusion*>> groupExclusions;
+    map<ParamCollection, size_t> groupIndex;
     for( ExclusionCollection::iterator iexcl = m_exclusions.begin(); iexcl != m_exclusions.end(); ++iexcl )
     {
         // paranoia; shouldn't happen
         assert( !iexcl->empty() );
         if( iexcl->empty() ) continue;
 
-        // form the intersection of the combinations associated with each of the
-        //  parameters that make up this exclusion
+        ParamCollection params;
+        for( Exclusion::iterator ix = iexcl->begin(); ix != iexcl->end(); ++ix )
+        {
+            params.push_back( ix->first );
+        }
+
+        auto ig = groupIndex.insert( make_pair( params, groupParams.size() ) );
+        if( ig.second )
+        {
+            groupParams.push_back( params );
+            groupExclusions.push_back( vector<const Exclusion*>() );
+        }
+        groupExclusions[ ig.first->second ].push_back( &*iexcl );
+    }
+
+    // If a group has no target, make a new combination from its parameters,
+    // mark all of its members satisfied, and make sure all the parameters in the new
+    // combination still have sorted combination collections.
+    for( size_t group = 0; group < groupParams.size(); ++group )
+    {
         ComboCollection intersection;
-        Exclusion::iterator iexclterm = iexcl->begin();
-        Parameter* sourceParam = iexclterm->first;
-        ComboCollection::const_iterator posCandidate = sourceParam->GetCombinationBegin();
-        while( true )
+        intersectCombinations( groupParams[ group ], intersection );
+        if( intersection.empty() )
         {
-            // We're going around and around...
-            if( iexcl->end() == ++iexclterm )
+            Combination *pNewCombo = m_comboArena.NewCombination( this, groupParams[ group ], COVERED );
+            for( ParamCollection::iterator ip = groupParams[ group ].begin(); ip != groupParams[ group ].end(); ++ip )
             {
-                iexclterm = iexcl->begin();
+                ( *ip )->LinkCombination( pNewCombo );
+                ( *ip )->SortCombinations();
             }
+            vecCombo.push_back( pNewCombo );
+        }
+    }
 
-            if( iexclterm->first == sourceParam )
+    // every combination gets all the exclusions whose parameters it contains
+    unordered_map<Combination*, vector<size_t>> comboGroups;
+    ComboCollection targets;
+    for( size_t group = 0; group < groupParams.size(); ++group )
+    {
+        ComboCollection intersection;
+        intersectCombinations( groupParams[ group ], intersection );
+        for( ComboCollection::iterator ic = intersection.begin(); ic != intersection.end(); ++ic )
+        {
+            vector<size_t>& groups = comboGroups[ *ic ];
+            if( groups.empty() ) targets.push_back( *ic );
+            groups.push_back( group );
+        }
+    }
+
+    // combinations keep their coverage to themselves so they can be worked on side by side,
+    //  the open counts feed the global count and are settled afterwards
+    vector<int> excluded( targets.size(), 0 );
+    GetWorkers().Run( static_cast<int>( targets.size() ), [ & ]( int item, int ) {
+        Combination* combo = targets[ item ];
+        vector<int> positions;
+        for( size_t group : comboGroups.find( combo )->second )
+        {
+            positions.clear();
+            for( Parameter* param : groupParams[ group ] )
             {
-                intersection.push_back( *posCandidate );
-                if( ++posCandidate == sourceParam->GetCombinationEnd() ) break;
+                Parameter* const* ip = find( combo->GetParameterBegin(), combo->GetParameterEnd(), param );
+                positions.push_back( static_cast<int>( ip - combo->GetParameterBegin() ) );
             }
-            // find next >= in this param
-            ComboCollection::const_iterator posLB = lower_bound( iexclterm->first->GetCombinationBegin(),
-                                                                 iexclterm->first->GetCombinationEnd(),
-                                                                 *posCandidate, CombinationPtrSortPred() );
-            if( iexclterm->first->GetCombinationEnd() == posLB ) break;
-            
-            // if >, reset candidate and source
-            if( *posLB != *posCandidate )
+            for( const Exclusion* excl : groupExclusions[ group ] )
             {
-                posCandidate = posLB;
-                sourceParam = iexclterm->first;
+                excluded[ item ] += combo->ExcludeTuples( *excl, positions.data() );
             }
         }
-        // If the result is empty, make a new combination from the exclusion,
-        // mark all of its members satisfied, and make sure all the parameters in the new
-        // combination still have sorted combination collections.
-        if( intersection.empty() )
+    } );
+
+    for( size_t item = 0; item < targets.size(); ++item )
+    {
+        targets[ item ]->DropOpen( excluded[ item ] );
+    }
+}
+
+//
+// the combinations that contain all of the given parameters, in id order
+//
+void Model::intersectCombinations( const ParamCollection& params, ComboCollection& intersection )
+{
+    ParamCollection::const_iterator iparam = params.begin();
+    Parameter* sourceParam = *iparam;
+    ComboCollection::const_iterator posCandidate = sourceParam->GetCombinationBegin();
+    if( sourceParam->GetCombinationEnd() == posCandidate ) return;
+    while( true )
+    {
+        // We're going around and around...
+        if( params.end() == ++iparam )
+        {
+            iparam = params.begin();
+        }
+
+        if( *iparam == sourceParam )
         {
-            Combination *pNewCombo = new Combination( this );
-            int size = 1;
-            for( Exclusion::iterator ix = iexcl->begin(); ix != iexcl->end(); ++ix )
+            intersection.push_back( *posCandidate );
+            if( ++posCandidate == sourceParam->GetCombinationEnd() ) break;
+        }
+        // find next >= in this param
+        ComboCollection::const_iterator posLB = lower_bound( ( *iparam )->GetCombinationBegin(),
+                                                             ( *iparam )->GetCombinationEnd(),
+                                                             *posCandidate, CombinationPtrSortPred() );
+        if( ( *iparam )->GetCombinationEnd() == posLB ) break;
+
+        // if >, reset candidate and source
+        if( *posLB != *posCandidate )
+        {
+            posCandidate = posLB;
+            sourceParam = *iparam;
+        }
+    }
+}
+
+//
+// with lazy constraints, open tuples no row can hold are only found by the solver; every
+//  completion it finds holds a tuple of each combination so those need no run of their own
+//
+void Model::excludeIncompletableTuples( ComboCollection& vecCombo )
+{
+    vector<vector<int>>  positions( vecCombo.size() );
+    vector<vector<char>> completable( vecCombo.size() );
+    for( size_t cidx = 0; cidx < vecCombo.size(); ++cidx )
+    {
+        for( int n = 0; n < vecCombo[ cidx ]->GetParameterCount(); ++n )
+        {
+            positions[ cidx ].push_back( m_solver.IndexOf( &( *vecCombo[ cidx ] )[ n ] ) );
+        }
+        completable[ cidx ].assign( vecCombo[ cidx ]->GetRange(), 0 );
+    }
+
+    vector<int> solution;
+    vector<ExclusionTerm> tuple;
+    for( size_t cidx = 0; cidx < vecCombo.size(); ++cidx )
+    {
+        Combination* combo = vecCombo[ cidx ];
+        for( int vidx = 0; vidx < combo->GetRange(); ++vidx )
+        {
+            if( !combo->IsOpen( vidx ) || completable[ cidx ][ vidx ] ) continue;
+
+            tuple.clear();
+            int key = vidx;
+            for( int n = combo->GetParameterCount() - 1; n >= 0; --n )
             {
-                pNewCombo->PushParameter( ( ix->first ) );
-                ix->first->LinkCombination( pNewCombo );
-                ix->first->SortCombinations();
-                size *= ix->first->GetValueCount();
+                tuple.push_back( make_pair( &( *combo )[ n ], combo->GetRadix( n ).DivMod( key ) ) );
+            }
+
+            if( m_solver.CanComplete( tuple, false, &solution ) )
+            {
+                for( size_t other = 0; other < vecCombo.size(); ++other )
+                {
+                    int index = 0;
+                    for( int n = 0; n < vecCombo[ other ]->GetParameterCount(); ++n )
+                    {
+                        index += solution[ positions[ other ][ n ] ] * vecCombo[ other ]->GetStride( n );
+                    }
+                    completable[ other ][ index ] = 1;
+                }
+            }
+            else
+            {
+                Exclusion excl;
+                for( auto & term : tuple )
+                {
+                    excl.insert( term );
+                }
+                combo->ApplyExclusion( excl );
             }
-            // Set size of combination's bit vector
-            pNewCombo->SetMapSize( size, COVERED );
-            vecCombo.push_back( pNewCombo );
-            intersection.push_back( pNewCombo );
         }
+    }
+}
 
-        for( ComboCollection::iterator ic = intersection.begin(); ic != intersection.end(); ++ic )
+//
+// draws tuples of a combination at random, weighted if asked to, until one comes up the row
+//  being built can still be completed with; those that can't are dropped from the candidates
+//
+int Model::drawCompletable( Combination* combo, vector<int>& candidates, bool weighted )
+{
+    vector<ExclusionTerm> tuple;
+    while( !candidates.empty() )
+    {
+        size_t pick = 0;
+        if( weighted )
         {
-            // all exclusions must be applied to the combo and not just the current one
-            for( ExclusionCollection::iterator ie = m_exclusions.begin(); ie != m_exclusions.end(); ++ie )
+            int totalWeight = 0;
+            for( int vidx : candidates )
+            {
+                totalWeight += combo->Weight( vidx );
+            }
+            int draw = Random( totalWeight );
+            while( draw >= combo->Weight( candidates[ pick ] ) )
             {
-                ( *ic )->ApplyExclusion( const_cast<Exclusion&> ( *ie ) );
+                draw -= combo->Weight( candidates[ pick++ ] );
             }
         }
+        else
+        {
+            pick = Random( candidates.size() );
+        }
+
+        tuple.clear();
+        int key = candidates[ pick ];
+        for( int n = combo->GetParameterCount() - 1; n >= 0; --n )
+        {
+            tuple.push_back( make_pair( &( *combo )[ n ], combo->GetRadix( n ).DivMod( key ) ) );
+        }
+        if( m_solver.CanComplete( tuple, true ) ) return( candidates[ pick ] );
+
+        candidates[ pick ] = candidates.back();
+        candidates.pop_back();
     }
+    return( -1 );
 }
 
 //
-// checks whether a given row violates any exclusions
+// checks whether a given row of the parameters' results violates any exclusions
 // this function will be invoked only during preview generation
 //
-bool Model::rowViolatesExclusion( ResultRow& row )
+bool Model::rowViolatesExclusion( size_t row )
 {
-    for( ExclusionCollection::iterator ie = m_exclusions.begin(); ie != m_exclusions.end(); ++ie )
+    if( nullptr == m_task->GetRowPredicate() && m_exclusionIndex.Empty() ) return( false );
+
+    m_rowValues.assign( m_rowValues.size(), -1 );
+    for( ParamCollection::iterator ip = m_parameters.begin(); ip != m_parameters.end(); ++ip )
     {
-        bool matches = true;
-        for( Exclusion::iterator it = ie->begin(); it != ie->end(); ++it )
+        int sequence = ( *ip )->GetSequence();
+        if( sequence >= static_cast<int>( m_rowValues.size() ) )
         {
-            if( static_cast<int>(row[ it->first->GetSequence() ]) != it->second )
-            {
-                matches = false;
-                break;
-            }
+            m_rowValues.resize( sequence + 1, -1 );
         }
-        if( matches ) return( true );
+        m_rowValues[ sequence ] = static_cast<int>( ( *ip )->GetTempResults().Get( row ) );
     }
-    return( false );
+    return( rowValuesViolateExclusion() );
 }
 
 //
@@ -1246,14 +1690,68 @@ bool Model::rowViolatesExclusion( ResultRow& row )
 //
 bool Model::rowViolatesExclusion( Exclusion& row )
 {
-    for( ExclusionCollection::iterator ie = m_exclusions.begin(); ie != m_exclusions.end(); ++ie )
+    if( nullptr == m_task->GetRowPredicate() && m_exclusionIndex.Empty() ) return( false );
+
+    m_rowValues.assign( m_rowValues.size(), -1 );
+    for( Exclusion::iterator it = row.begin(); it != row.end(); ++it )
     {
-        if( contained( const_cast<Exclusion&> ( *ie ), row ) )
+        int sequence = it->first->GetSequence();
+        if( sequence >= static_cast<int>( m_rowValues.size() ) )
         {
-            return( true );
+            m_rowValues.resize( sequence + 1, -1 );
         }
+        m_rowValues[ sequence ] = it->second;
     }
-    return( false );
+    return( rowValuesViolateExclusion() );
+}
+
+//
+// checks the row put in m_rowValues; the task's predicate only knows the actual parameters so
+//  a pseudoparameter's value is looked up in its submodel's results, a parameter two submodels
+//  share must then get the same value from both
+//
+bool Model::rowValuesViolateExclusion()
+{
+    const RowPredicate* predicate = m_task->GetRowPredicate();
+    if( nullptr == predicate )
+    {
+        return( !m_exclusionIndex.Empty() && m_exclusionIndex.Matches( m_rowValues ) );
+    }
+
+    auto assign = [ this ]( Parameter* param, size_t value ) -> bool {
+        int sequence = param->GetSequence();
+        if( sequence >= static_cast<int>( m_predicateValues.size() ) )
+        {
+            m_predicateValues.resize( sequence + 1, -1 );
+        }
+        int& assigned = m_predicateValues[ sequence ];
+        if( assigned >= 0 && assigned != static_cast<int>( value ) ) return( false );
+        assigned = static_cast<int>( value );
+        return( true );
+    };
+
+    m_predicateValues.assign( m_predicateValues.size(), -1 );
+    for( ParamCollection::iterator ip = m_parameters.begin(); ip != m_parameters.end(); ++ip )
+    {
+        int sequence = ( *ip )->GetSequence();
+        int value = sequence < static_cast<int>( m_rowValues.size() ) ? m_rowValues[ sequence ] : -1;
+        if( value < 0 ) continue;
+
+        ParamCollection* comps = ( *ip )->GetComponents();
+        if( nullptr == comps )
+        {
+            if( !assign( *ip, value ) ) return( true );
+            continue;
+        }
+
+        ResultTable& results = ( *ip )->GetModel()->GetResults();
+        for( size_t nComp = 0; nComp < comps->size(); ++nComp )
+        {
+            size_t mapped = results.Get( value, nComp );
+            if( Parameter::UndefinedValue != mapped && !assign( ( *comps )[ nComp ], mapped ) ) return( true );
+        }
+    }
+    return( predicate->Violates( m_predicateValues ) );
 }
 
 //
@@ -1305,7 +1803,7 @@ void Model::mapRowSeedsToPseudoParameters()
                                 break;
                             }
                             int nParam = static_cast<int>( distance( comps->begin(), ip ) );
-                            int nRealVal = static_cast<int>(param->GetModel()->GetResults()[ vidx ][ nParam ]);
+                            int nRealVal = static_cast<int>(param->GetModel()->GetResults().Get( vidx, nParam ));
                             if( nRealVal != irel->second )
                             {
                                 break;
@@ -1441,6 +1939,24 @@ void Model::fixRowSeeds()
         }
     }
 
+    // with lazy constraints a seed can also conflict with them through the values it leaves open
+    if( m_solver.IsActive() )
+    {
+        RowSeedCollection::iterator is = m_rowSeeds.begin();
+        while( is != m_rowSeeds.end() )
+        {
+            vector<ExclusionTerm> terms( is->begin(), is->end() );
+            if( !m_solver.CanComplete( terms, false ) )
+            {
+                is = m_rowSeeds.erase( is );
+            }
+            else
+            {
+                ++is;
+            }
+        }
+    }
+
     DOUT( L"After excl violating seeds removed. Row seeds number: " << static_cast<int>( m_rowSeeds.size() ) << L"\n" );
     for_each( m_rowSeeds.begin(), m_rowSeeds.end(), printRowSeed );
 }
@@ -1,9 +1,12 @@
-#include "generator.h"
+#include "rowpicker.h"
 using namespace std;
 
 namespace pictcore
 {
 
+// below this many combination lookups scoring values on a single thread is faster
+const size_t MinParallelScoringWork = 2048;
+
 //
 //
 //
@@ -13,7 +16,7 @@ void Parameter::CleanUp()
     m_bound   = false;
 
     m_combinations.clear();
-    m_result.clear();
+    m_result.Clear();
     m_exclusions.clear();
 }
 
@@ -29,7 +32,7 @@ bool Parameter::Bind(int value, WorkList& worklist)
     assert(!m_bound);
     assert(value < m_valueCount);
 
-    m_result.push_back(value);
+    m_result.Append(value);
     m_currentValue = value;
     m_bound = true;
 
@@ -55,83 +58,62 @@ bool Parameter::Bind(int value, WorkList& worklist)
 
 //
 // This method chooses the value for this parameter in the current context
+// Values get scored first, possibly on several threads, and then compared in order
+//  so the choice and the random tie-breaks do not depend on the number of threads
 //
-int Parameter::PickValue()
+int Parameter::PickValue( Model& model )
 {
     assert(!m_bound);
 
-    int maxComplete    = 0;
-    int maxTotal       = 0;
-    int bestValue      = 0;
-    int bestValueCount = 0;
-
-    m_bound = true; // a white lie to facilitate Combination::Feasible()
+    ModelBindings bindings( model );
+    RowPicker<ModelBindings> picker( bindings );
+    vector<ValueScore> scores( m_valueCount );
 
-    for (int value = 0; value < m_valueCount; ++value)
+    WorkerPool& workers = model.GetWorkers();
+    if( workers.GetThreadCount() > 1
+     && m_valueCount * m_combinations.size() >= MinParallelScoringWork )
     {
-        int totalZeros = 0;
-        int complete   = 0;
-        // try binding that value and see how feasible it is
-        m_currentValue = value;
-
-        for (ComboCollection::iterator iter = m_combinations.begin(); iter != m_combinations.end(); ++iter)
-        {
-            int zeros = (*iter)->Feasible();
-            totalZeros += zeros;
-            if ((*iter)->GetBoundCount() >= (*iter)->GetParameterCount() - 1)
-            {
-                if (zeros)
-                    ++complete;
-
-                if ((*iter)->ViolatesExclusion())
-                {
-                    // make sure we don't pick this value, and move on
-                    totalZeros = -1;
-                    complete   = -1;
-                    break;
-                }
-            }
-        }
-        if (complete > maxComplete)
+        workers.Run( m_valueCount, [ this, &model, &picker, &scores ]( int value, int slot ) {
+            picker.ScoreValue( *this, value, model.GetWorkbuf( slot ), scores[ value ] );
+        } );
+    }
+    else
+    {
+        int* workbuf = model.GetWorkbuf();
+        for (int value = 0; value < m_valueCount; ++value)
         {
-            maxComplete    = complete;
-            bestValue      = value;
-            maxTotal       = totalZeros;
-            bestValueCount = 1;
+            picker.ScoreValue( *this, value, workbuf, scores[ value ] );
         }
-        else if (complete == maxComplete)
+    }
+
+    // with lazy constraints a value may be ruled out by the exclusions only together with the
+    //  values the row has yet to get
+    ConstraintSolver& solver = model.GetSolver();
+    if( solver.IsActive() )
+    {
+        vector<ExclusionTerm> assumption( 1 );
+        for( int value = 0; value < m_valueCount; ++value )
         {
-            if (totalZeros > maxTotal)
-            {
-                bestValue      = value;
-                maxTotal       = totalZeros;
-                bestValueCount = 1;
-            }
-            else if (!m_valueWeights.empty() && 0 == totalZeros && 0 == maxTotal)
-            {
-                // Arbitrary choice - we already have this parameter covered
-                // Use weights if they exist
-                bestValueCount += GetWeight(value);
-                if (rand() % bestValueCount < GetWeight(value))
-                {
-                    bestValue = value;
-                }
-            }
-            else if (totalZeros == maxTotal && !(rand() % ++bestValueCount))
+            if( scores[ value ].complete < 0 ) continue;
+
+            assumption[ 0 ] = make_pair( this, value );
+            if( !solver.CanComplete( assumption, true ) )
             {
-                bestValue = value;
-                maxTotal  = totalZeros;
+                scores[ value ].totalZeros = -1;
+                scores[ value ].complete   = -1;
             }
         }
     }
-    m_bound = false;
 
-    // What if bestValueCount is 0 here due to exclusions?
+    int bestValue;
+    bool found = picker.ChooseValue( *this, scores, bestValue );
+
+    // What if no value is left here due to exclusions?
     // That would be a bug, but better put in a check.
     if( m_task->GetGenerationMode() != GenerationMode::Preview )
     {
-        assert( bestValueCount > 0 );
-        if( bestValueCount <= 0 )
+        assert( found );
+        if( !found )
         {
             throw GenerationError( __FILE__, __LINE__, ErrorType::GenerationFailure );
         }
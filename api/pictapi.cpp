@@ -139,6 +139,7 @@ PictGenerate
         case ErrorType::TooManyRows:
         case ErrorType::Unknown:
         case ErrorType::GenerationFailure:
+        case ErrorType::TooRestrictive:
         default:
             return( PICT_GENERATION_ERROR );
         }
@@ -204,17 +205,18 @@ PictGetNextResultRow
 {
     Task* taskObj = static_cast<Task*>( NO_CONST_HANDLE( task ));
     
-    ResultCollection::iterator i_row = taskObj->GetNextResultRow();
+    ResultTable& results = taskObj->GetResults();
+    size_t row = taskObj->GetNextResultRow();
 
-    if( i_row != taskObj->GetResults().end() )
+    if( row != results.GetRowCount() )
     {
-        for( size_t index = 0; index < i_row->size(); ++index )
+        for( size_t index = 0; index < results.GetColumnCount(); ++index )
         {
-            resultRow[ index ] = (*i_row)[ index ];
+            resultRow[ index ] = results.Get( row, index );
         }
     }
     
-    return( distance( i_row, taskObj->GetResults().end() ));
+    return( results.GetRowCount() - row );
 }
 
 //
@@ -361,13 +363,29 @@ PictDeleteModel
 }
 
 //
+// Submodels come before the model they belong to, each level generated the way the root's
+// submodels are: side by side when they share no parameters
 //
-//
-void generate( Model* model )
+void generateSubmodels( Model* model )
 {
     for ( Model* subModel : model->GetSubmodels() )
     {
-        generate(subModel);
+        generateSubmodels( subModel );
+    }
+
+    vector<vector<Model*>> waves;
+    model->GetSubmodelWaves( waves );
+    for ( auto & wave : waves )
+    {
+        model->GetTask()->GenerateModels( wave );
     }
+}
+
+//
+//
+//
+void generate( Model* model )
+{
+    generateSubmodels( model );
     model->Generate();
 }
@@ -0,0 +1,98 @@
+#include "generator.h"
+using namespace std;
+
+namespace pictcore
+{
+
+//
+//
+//
+void ResultColumn::Append( size_t value )
+{
+    switch( m_width )
+    {
+    case 1:  m_narrow.push_back( UndefinedValue == value ? UINT8_MAX  : static_cast<uint8_t> ( value ) ); break;
+    case 2:  m_medium.push_back( UndefinedValue == value ? UINT16_MAX : static_cast<uint16_t>( value ) ); break;
+    default: m_wide.push_back  ( static_cast<uint32_t>( value ) ); break;
+    }
+}
+
+//
+//
+//
+void ResultColumn::Set( size_t row, size_t value )
+{
+    switch( m_width )
+    {
+    case 1:  m_narrow[ row ] = UndefinedValue == value ? UINT8_MAX  : static_cast<uint8_t> ( value ); break;
+    case 2:  m_medium[ row ] = UndefinedValue == value ? UINT16_MAX : static_cast<uint16_t>( value ); break;
+    default: m_wide[ row ]   = static_cast<uint32_t>( value ); break;
+    }
+}
+
+//
+//
+//
+void ResultColumn::Truncate( size_t rows )
+{
+    if( rows >= Size() ) return;
+
+    m_narrow.resize( min( rows, m_narrow.size() ) );
+    m_medium.resize( min( rows, m_medium.size() ) );
+    m_wide.resize  ( min( rows, m_wide.size() ) );
+}
+
+//
+// Rows are moved down in place, the rows to keep come in ascending order
+//
+void ResultColumn::KeepRows( const vector<size_t>& rows )
+{
+    for( size_t n = 0; n < rows.size(); ++n )
+    {
+        assert( rows[ n ] >= n );
+        switch( m_width )
+        {
+        case 1:  m_narrow[ n ] = m_narrow[ rows[ n ] ]; break;
+        case 2:  m_medium[ n ] = m_medium[ rows[ n ] ]; break;
+        default: m_wide[ n ]   = m_wide[ rows[ n ] ];   break;
+        }
+    }
+    Truncate( rows.size() );
+}
+
+//
+//
+//
+ResultColumn ResultColumn::Detach()
+{
+    ResultColumn column;
+    column.m_width = m_width;
+    column.m_narrow.swap( m_narrow );
+    column.m_medium.swap( m_medium );
+    column.m_wide.swap( m_wide );
+    return( column );
+}
+
+//
+//
+//
+void ResultTable::Truncate( size_t rows )
+{
+    for( auto & column : m_columns )
+    {
+        column.Truncate( rows );
+    }
+}
+
+//
+//
+//
+void ResultTable::KeepRows( const vector<size_t>& rows )
+{
+    for( auto & column : m_columns )
+    {
+        column.KeepRows( rows );
+    }
+}
+
+}
@@ -0,0 +1,156 @@
+#include "rowpicker.h"
+using namespace std;
+
+namespace pictcore
+{
+
+//
+//
+//
+void RowLayout::Build( ParamCollection& params, ComboCollection& combos, ComboQueue& queue, bool strict )
+{
+    m_params = params;
+    m_combos = combos;
+    m_queue  = &queue;
+    m_strict = strict;
+
+    for( int p = 0; p < static_cast<int>( m_params.size() ); ++p )
+    {
+        m_params[ p ]->SetLayoutIndex( p );
+    }
+    for( int c = 0; c < static_cast<int>( m_combos.size() ); ++c )
+    {
+        m_combos[ c ]->SetLayoutIndex( c );
+    }
+}
+
+//
+//
+//
+RowBuilder::RowBuilder( const RowLayout& layout ) :
+    m_layout     ( &layout ),
+    m_values     ( layout.m_params.size(), -1 ),
+    m_pending    ( layout.m_params.size(), 0 ),
+    m_boundCounts( layout.m_combos.size(), 0 ),
+    m_unbound    ( 0 ),
+    m_score      ( 0 )
+{
+}
+
+//
+// Follows the main loop of Model::gcd: seed the row with the most open combination
+// whenever the work list runs dry, otherwise pick values for the parameters on it
+//
+bool RowBuilder::Build( unsigned int seed, int* workbuf )
+{
+    m_random.seed( seed );
+
+    fill( m_values.begin(), m_values.end(), -1 );
+    fill( m_pending.begin(), m_pending.end(), 0 );
+    fill( m_boundCounts.begin(), m_boundCounts.end(), 0 );
+    m_worklist.clear();
+    m_unbound = static_cast<int>( m_values.size() );
+    m_score   = 0;
+
+    RowPicker<RowBuilder> picker( *this );
+    vector<ValueScore> scores;
+
+    while( m_unbound > 0 )
+    {
+        if( m_worklist.empty() )
+        {
+            int maxOpen = 0;
+            Combination* choice = picker.PickMostOpen( *m_layout->m_queue, maxOpen, workbuf );
+
+            // no zeros were found anywhere, pick the best matching one
+            if( nullptr == choice )
+            {
+                choice = picker.PickBestMatch( m_layout->m_combos );
+                if( nullptr == choice ) return( false );
+            }
+
+            // no combo had any uncovered combinations in it
+            int key = 0 == maxOpen ? picker.PickWeightedTuple( *choice ) : picker.PickOpenTuple( *choice );
+            if( key < 0 ) return( false );
+
+            bindCombination( *choice, key );
+        }
+        else
+        {
+            Parameter* param = m_worklist.front();
+            m_worklist.pop_front();
+
+            scores.resize( param->GetValueCount() );
+            for( int value = 0; value < param->GetValueCount(); ++value )
+            {
+                picker.ScoreValue( *param, value, workbuf, scores[ value ] );
+            }
+
+            int value;
+            if( !picker.ChooseValue( *param, scores, value ) && m_layout->m_strict ) return( false );
+            bind( param, value );
+        }
+    }
+
+    // count the open tuples the row would cover
+    for( auto combo : m_layout->m_combos )
+    {
+        int key = 0;
+        for( int n = 0; n < combo->GetParameterCount(); ++n )
+        {
+            key += Value( combo->GetParameterBegin()[ n ] ) * combo->GetStride( n );
+        }
+        if( combo->IsOpen( key ) ) ++m_score;
+    }
+
+    return( true );
+}
+
+//
+//
+//
+void RowBuilder::bindCombination( const Combination& combo, int key )
+{
+    for( int n = 0; n < combo.GetParameterCount(); ++n )
+    {
+        m_pending[ combo.GetParameterBegin()[ n ]->GetLayoutIndex() ] = 1;
+    }
+
+    for( int n = combo.GetParameterCount() - 1; n >= 0; --n )
+    {
+        int value = combo.GetRadix( n ).DivMod( key );
+        Parameter* param = combo.GetParameterBegin()[ n ];
+        if( Value( param ) < 0 )
+        {
+            bind( param, value );
+        }
+    }
+}
+
+//
+// Any parameter that is all that's missing to complete a combination goes on the work list
+//
+void RowBuilder::bind( Parameter* param, int value )
+{
+    m_values[ param->GetLayoutIndex() ] = value;
+    --m_unbound;
+
+    for( auto iter = param->GetCombinationBegin(); iter != param->GetCombinationEnd(); ++iter )
+    {
+        const Combination& combo = **iter;
+        if( ++m_boundCounts[ combo.GetLayoutIndex() ] == combo.GetParameterCount() - 1 )
+        {
+            for( int n = 0; n < combo.GetParameterCount(); ++n )
+            {
+                Parameter* other = combo.GetParameterBegin()[ n ];
+                if( Value( other ) < 0 && !m_pending[ other->GetLayoutIndex() ] )
+                {
+                    m_worklist.push_back( other );
+                    m_pending[ other->GetLayoutIndex() ] = 1;
+                }
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,338 @@
+#pragma once
+
+#include "generator.h"
+#include "simd.h"
+
+namespace pictcore
+{
+
+//
+// how a value of a parameter scores against the combinations of the parameter
+//
+struct ValueScore
+{
+    int complete;   // combinations the value would complete with an open tuple
+    int totalZeros; // open tuples still feasible with the value
+};
+
+//
+// binding state of the model itself, the one Model::gcd builds rows on
+//
+class ModelBindings
+{
+public:
+    ModelBindings( Model& model ) : m_model( model ) {}
+
+    int Value( const Parameter* param ) const
+    {
+        return( param->GetBoundCount() ? static_cast<int>( param->GetLast() ) : -1 );
+    }
+    int BoundCount( const Combination* combo ) const { return( combo->GetBoundCount() ); }
+    int Random( size_t n ) { return( m_model.Random( n ) ); }
+
+private:
+    Model& m_model;
+};
+
+//
+// scoring and selection steps of building a row, shared by Model::gcd and RowBuilder
+// State tells the value bound to a parameter (-1 while unbound), how many parameters of a
+// combination are bound, and draws the random numbers ties are broken with; all the steps
+// only read the coverage maps and the const ones may run on several threads at a time
+//
+template<class State>
+class RowPicker
+{
+public:
+    RowPicker( State& state ) : m_state( state ) {}
+
+    //
+    // Counts the open tuples in the projection of the bound values onto a combination,
+    //  with candidate taken as bound to value
+    // Unbound parameters at the end of the combination make each projected key a run of
+    //  consecutive tuples so only the keys of the leading parameters get expanded
+    //
+    int CountOpen( const Combination& combo, const Parameter* candidate, int value, int* workbuf ) const
+    {
+        Parameter* const* params  = combo.GetParameterBegin();
+        Parameter* const* leadEnd = combo.GetParameterEnd();
+        int runLength = 1;
+        while( leadEnd != params && *( leadEnd - 1 ) != candidate && m_state.Value( *( leadEnd - 1 ) ) < 0 )
+        {
+            --leadEnd;
+            runLength *= ( *leadEnd )->GetValueCount();
+        }
+
+        int nWorkVals = 1;
+        workbuf[ 0 ] = 0;
+        for( Parameter* const* iter = params; iter != leadEnd; ++iter )
+        {
+            int valueCount = ( *iter )->GetValueCount();
+            int current    = *iter == candidate ? value : m_state.Value( *iter );
+            if( current >= 0 )
+            {
+                simd::ScaleAdd( workbuf, nWorkVals, valueCount, current );
+            }
+            else
+            {
+                simd::ScaleAdd( workbuf, nWorkVals, valueCount, 0 );
+                simd::Expand( workbuf, nWorkVals, valueCount );
+                nWorkVals *= valueCount;
+            }
+        }
+
+        const CoverageMap& coverage = combo.GetCoverage();
+        if( 1 == runLength )
+        {
+            return( coverage.CountOpen( workbuf, nWorkVals ) );
+        }
+
+        int zeros = 0;
+        for( int i = 0; i < nWorkVals; ++i )
+        {
+            zeros += coverage.CountOpen( workbuf[ i ] * runLength, runLength );
+        }
+        return( zeros );
+    }
+
+    //
+    // See if a tuple matches the bound values
+    //
+    ComboStatus GetStatus( const Combination& combo, int key ) const
+    {
+        if( combo.IsExcluded( key ) )
+        {
+            return( ComboStatus::Excluded );
+        }
+        ComboStatus retval = combo.IsOpen( key ) ? ComboStatus::Open : ComboStatus::CoveredMatch;
+
+        for( int n = combo.GetParameterCount() - 1; n >= 0; --n )
+        {
+            int current = combo.GetRadix( n ).DivMod( key );
+            int bound   = m_state.Value( combo.GetParameterBegin()[ n ] );
+            if( bound >= 0 && bound != current )
+            {
+                return( ComboStatus::Excluded );
+            }
+        }
+        return( retval );
+    }
+
+    //
+    // Checks the fully bound tuple, with candidate bound to value, against the exclusions
+    //
+    bool ViolatesExclusion( const Combination& combo, const Parameter* candidate, int value ) const
+    {
+        int key = 0;
+        for( int n = 0; n < combo.GetParameterCount(); ++n )
+        {
+            const Parameter* param = combo.GetParameterBegin()[ n ];
+            int current = param == candidate ? value : m_state.Value( param );
+            assert( current >= 0 );
+            key += current * combo.GetStride( n );
+        }
+        return( combo.IsExcluded( key ) );
+    }
+
+    //
+    // Scores one value against all combinations the parameter participates in
+    //
+    void ScoreValue( const Parameter& param, int value, int* workbuf, ValueScore& score ) const
+    {
+        score.totalZeros = 0;
+        score.complete   = 0;
+
+        for( auto iter = param.GetCombinationBegin(); iter != param.GetCombinationEnd(); ++iter )
+        {
+            const Combination& combo = **iter;
+            int zeros = CountOpen( combo, &param, value, workbuf );
+            score.totalZeros += zeros;
+            if( m_state.BoundCount( &combo ) >= combo.GetParameterCount() - 1 )
+            {
+                if( zeros ) ++score.complete;
+
+                if( ViolatesExclusion( combo, &param, value ) )
+                {
+                    // make sure we don't pick this value, and move on
+                    score.totalZeros = -1;
+                    score.complete   = -1;
+                    break;
+                }
+            }
+        }
+    }
+
+    //
+    // Compares the scores in order so the random tie-breaks do not depend on how they were taken
+    // Returns false if every value is ruled out, value is then the first one
+    //
+    bool ChooseValue( const Parameter& param, const std::vector<ValueScore>& scores, int& value )
+    {
+        int maxComplete    = 0;
+        int maxTotal       = 0;
+        int bestValue      = 0;
+        int bestValueCount = 0;
+
+        for( int v = 0; v < param.GetValueCount(); ++v )
+        {
+            int totalZeros = scores[ v ].totalZeros;
+            int complete   = scores[ v ].complete;
+
+            if( complete > maxComplete )
+            {
+                maxComplete    = complete;
+                bestValue      = v;
+                maxTotal       = totalZeros;
+                bestValueCount = 1;
+            }
+            else if( complete == maxComplete )
+            {
+                if( totalZeros > maxTotal )
+                {
+                    bestValue      = v;
+                    maxTotal       = totalZeros;
+                    bestValueCount = 1;
+                }
+                else if( param.HasWeights() && 0 == totalZeros && 0 == maxTotal )
+                {
+                    // Arbitrary choice - we already have this parameter covered
+                    // Use weights if they exist
+                    bestValueCount += param.GetWeight( v );
+                    if( m_state.Random( bestValueCount ) < param.GetWeight( v ) )
+                    {
+                        bestValue = v;
+                    }
+                }
+                else if( totalZeros == maxTotal && !m_state.Random( ++bestValueCount ) )
+                {
+                    bestValue = v;
+                    maxTotal  = totalZeros;
+                }
+            }
+        }
+
+        value = bestValue;
+        return( bestValueCount > 0 );
+    }
+
+    //
+    // Returns the combination with the most open tuples feasible in the row or nullptr if there
+    //  are none; ties are broken randomly
+    // A combination's open count is an upper bound of the number of its open tuples that are
+    //  still feasible in the row so once a bucket's count drops below the best number found so
+    //  far, none of the remaining buckets can hold a better combination. For combinations none
+    //  of whose parameters are bound yet the bound is exact.
+    //
+    Combination* PickMostOpen( const ComboQueue& queue, int& maxOpen, int* workbuf )
+    {
+        m_ties.clear();
+        maxOpen = 0;
+        for( int count = queue.GetTop(); count > 0 && count >= maxOpen; --count )
+        {
+            for( Combination* combo = queue.GetBucket( count ); combo != nullptr; combo = combo->GetQueueNext() )
+            {
+                int bound = m_state.BoundCount( combo );
+                if( bound == combo->GetParameterCount() ) continue;
+
+                int open = ( 0 == bound ) ? count : CountOpen( *combo, nullptr, 0, workbuf );
+                if( open > maxOpen )
+                {
+                    maxOpen = open;
+                    m_ties.clear();
+                }
+                if( open > 0 && open == maxOpen )
+                {
+                    m_ties.push_back( combo );
+                }
+            }
+        }
+
+        if( m_ties.empty() ) return( nullptr );
+
+        return( m_ties[ m_state.Random( m_ties.size() ) ] );
+    }
+
+    //
+    // When no open tuples are left anywhere: the combination with the most covered tuples
+    //  matching the row, nullptr if there are none
+    //
+    Combination* PickBestMatch( const ComboCollection& combos )
+    {
+        Combination* choice = nullptr;
+        int maxMatch = 0;
+        int ties     = 0;
+        for( auto combo : combos )
+        {
+            if( m_state.BoundCount( combo ) == combo->GetParameterCount() ) continue;
+
+            int match = 0;
+            for( int vidx = 0; vidx < combo->GetRange(); ++vidx )
+            {
+                if( ComboStatus::CoveredMatch == GetStatus( *combo, vidx ) )
+                {
+                    ++match;
+                }
+            }
+
+            if( match > maxMatch )
+            {
+                choice   = combo;
+                ties     = 1;
+                maxMatch = match;
+            }
+            // if there's a tie in match, pick randomly
+            else if( match > 0 && match == maxMatch && !m_state.Random( ++ties ) )
+            {
+                choice = combo;
+            }
+        }
+        return( choice );
+    }
+
+    //
+    // An open tuple matching the row, -1 if there are none
+    //
+    int PickOpenTuple( const Combination& combo )
+    {
+        m_tuples.clear();
+        for( int vidx = 0; vidx < combo.GetRange(); ++vidx )
+        {
+            if( ComboStatus::Open == GetStatus( combo, vidx ) )
+            {
+                m_tuples.push_back( vidx );
+            }
+        }
+        if( m_tuples.empty() ) return( -1 );
+
+        return( m_tuples[ m_state.Random( m_tuples.size() ) ] );
+    }
+
+    //
+    // A tuple matching the row drawn by the weights of its values, -1 if there are none
+    //
+    int PickWeightedTuple( const Combination& combo )
+    {
+        int totalWeight = 0;
+        int key = -1;
+        for( int vidx = 0; vidx < combo.GetRange(); ++vidx )
+        {
+            if( ComboStatus::Excluded != GetStatus( combo, vidx ) )
+            {
+                int weight = combo.Weight( vidx );
+                totalWeight += weight;
+                if( m_state.Random( totalWeight ) < weight )
+                {
+                    key = vidx;
+                }
+            }
+        }
+        return( key );
+    }
+
+private:
+    State&                    m_state;
+    std::vector<Combination*> m_ties;
+    std::vector<int>          m_tuples;
+};
+
+}
@@ -0,0 +1,262 @@
+#include "simd.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// gcc and clang only emit vector instructions in functions explicitly targeting them
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+namespace pictcore
+{
+namespace simd
+{
+
+namespace
+{
+
+typedef uint64_t Word;
+
+#if defined(SIMD_X64)
+
+//
+// SSE4.2 kernels, four keys at a time and the popcnt instruction
+//
+SIMD_TARGET("sse4.2,popcnt")
+void scaleAddSse42( int* buf, int count, int factor, int addend )
+{
+    __m128i f = _mm_set1_epi32( factor );
+    __m128i a = _mm_set1_epi32( addend );
+    int i = 0;
+    for( ; i + 4 <= count; i += 4 )
+    {
+        __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( buf + i ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( buf + i ), _mm_add_epi32( _mm_mullo_epi32( v, f ), a ) );
+    }
+    ScaleAddPortable( buf + i, count - i, factor, addend );
+}
+
+SIMD_TARGET("sse4.2,popcnt")
+void expandSse42( int* buf, int count, int valueCount )
+{
+    for( int addend = 1; addend < valueCount; ++addend )
+    {
+        int* replica = buf + count * addend;
+        __m128i a = _mm_set1_epi32( addend );
+        int i = 0;
+        for( ; i + 4 <= count; i += 4 )
+        {
+            __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( buf + i ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( replica + i ), _mm_add_epi32( v, a ) );
+        }
+        for( ; i < count; ++i )
+        {
+            replica[ i ] = buf[ i ] + addend;
+        }
+    }
+}
+
+SIMD_TARGET("sse4.2,popcnt")
+int countRunSse42( const Word* plane, int first, int count )
+{
+    if( count <= 0 ) return 0;
+
+    int last  = first + count - 1;
+    int wLow  = first >> 6;
+    int wHigh = last  >> 6;
+    Word lowMask  = ~Word( 0 ) << ( first & 63 );
+    Word highMask = ~Word( 0 ) >> ( 63 - ( last & 63 ) );
+
+    if( wLow == wHigh )
+    {
+        return static_cast<int>( _mm_popcnt_u64( plane[ wLow ] & lowMask & highMask ) );
+    }
+
+    long long total = _mm_popcnt_u64( plane[ wLow ] & lowMask );
+    for( int w = wLow + 1; w < wHigh; ++w )
+    {
+        total += _mm_popcnt_u64( plane[ w ] );
+    }
+    total += _mm_popcnt_u64( plane[ wHigh ] & highMask );
+    return static_cast<int>( total );
+}
+
+//
+// AVX2 kernels, eight keys at a time; bits are gathered as 32-bit words which on
+// a little-endian processor hold bit n of the plane at bit n % 32 of word n / 32
+//
+SIMD_TARGET("avx2,popcnt")
+void scaleAddAvx2( int* buf, int count, int factor, int addend )
+{
+    __m256i f = _mm256_set1_epi32( factor );
+    __m256i a = _mm256_set1_epi32( addend );
+    int i = 0;
+    for( ; i + 8 <= count; i += 8 )
+    {
+        __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( buf + i ) );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( buf + i ), _mm256_add_epi32( _mm256_mullo_epi32( v, f ), a ) );
+    }
+    ScaleAddPortable( buf + i, count - i, factor, addend );
+}
+
+SIMD_TARGET("avx2,popcnt")
+void expandAvx2( int* buf, int count, int valueCount )
+{
+    for( int addend = 1; addend < valueCount; ++addend )
+    {
+        int* replica = buf + count * addend;
+        __m256i a = _mm256_set1_epi32( addend );
+        int i = 0;
+        for( ; i + 8 <= count; i += 8 )
+        {
+            __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( buf + i ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( replica + i ), _mm256_add_epi32( v, a ) );
+        }
+        for( ; i < count; ++i )
+        {
+            replica[ i ] = buf[ i ] + addend;
+        }
+    }
+}
+
+SIMD_TARGET("avx2,popcnt")
+int countSetAvx2( const Word* plane, const int* positions, int count )
+{
+    const int* words = reinterpret_cast<const int*>( plane );
+    __m256i low5  = _mm256_set1_epi32( 31 );
+    __m256i one   = _mm256_set1_epi32( 1 );
+    __m256i total = _mm256_setzero_si256();
+    int i = 0;
+    for( ; i + 8 <= count; i += 8 )
+    {
+        __m256i pos  = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( positions + i ) );
+        __m256i word = _mm256_i32gather_epi32( words, _mm256_srli_epi32( pos, 5 ), 4 );
+        __m256i bits = _mm256_srlv_epi32( word, _mm256_and_si256( pos, low5 ) );
+        total = _mm256_add_epi32( total, _mm256_and_si256( bits, one ) );
+    }
+
+    __m128i sum = _mm_add_epi32( _mm256_castsi256_si128( total ), _mm256_extracti128_si256( total, 1 ) );
+    sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+    sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    int result = _mm_cvtsi128_si32( sum );
+
+    return result + CountSetPortable( plane, positions + i, count - i );
+}
+
+//
+// CPU feature detection; gcc's built-ins and the xgetbv check below also make sure
+// the operating system preserves the AVX registers
+//
+#if defined(_MSC_VER)
+bool hasSse42()
+{
+    int info[ 4 ];
+    __cpuid( info, 1 );
+    return ( info[ 2 ] & ( 1 << 20 ) ) && ( info[ 2 ] & ( 1 << 23 ) );
+}
+
+bool hasAvx2()
+{
+    int info[ 4 ];
+    __cpuid( info, 1 );
+    bool osxsave = 0 != ( info[ 2 ] & ( 1 << 27 ) );
+    if( !osxsave || 6 != ( _xgetbv( 0 ) & 6 ) ) return false;
+    __cpuidex( info, 7, 0 );
+    return 0 != ( info[ 1 ] & ( 1 << 5 ) );
+}
+#else
+bool hasSse42()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "sse4.2" ) && __builtin_cpu_supports( "popcnt" );
+}
+
+bool hasAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "popcnt" );
+}
+#endif
+
+#endif // SIMD_X64
+
+//
+// Dispatch table, filled in once when the library loads
+//
+struct Kernels
+{
+    void ( *scaleAdd )( int*, int, int, int );
+    void ( *expand )  ( int*, int, int );
+    int  ( *countSet )( const Word*, const int*, int );
+    int  ( *countRun )( const Word*, int, int );
+};
+
+Kernels selectKernels()
+{
+    Kernels kernels = { ScaleAddPortable, ExpandPortable, CountSetPortable, CountRunPortable };
+#if defined(SIMD_X64)
+    if( hasAvx2() )
+    {
+        kernels.scaleAdd = scaleAddAvx2;
+        kernels.expand   = expandAvx2;
+        kernels.countSet = countSetAvx2;
+        kernels.countRun = countRunSse42;
+    }
+    else if( hasSse42() )
+    {
+        kernels.scaleAdd = scaleAddSse42;
+        kernels.expand   = expandSse42;
+        kernels.countRun = countRunSse42;
+        // no countSet kernel: without a gather instruction, positions scattered over the plane
+        // are counted no faster than by the portable loop
+    }
+#endif
+    return( kernels );
+}
+
+const Kernels g_kernels = selectKernels();
+
+}
+
+//
+//
+//
+void ScaleAddKernel( int* buf, int count, int factor, int addend )
+{
+    g_kernels.scaleAdd( buf, count, factor, addend );
+}
+
+//
+//
+//
+void ExpandKernel( int* buf, int count, int valueCount )
+{
+    g_kernels.expand( buf, count, valueCount );
+}
+
+//
+//
+//
+int CountSetKernel( const uint64_t* plane, const int* positions, int count )
+{
+    return( g_kernels.countSet( plane, positions, count ) );
+}
+
+//
+//
+//
+int CountRunKernel( const uint64_t* plane, int first, int count )
+{
+    return( g_kernels.countRun( plane, first, count ) );
+}
+
+}
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+
+namespace pictcore
+{
+
+//
+// vectorized kernels behind RowPicker::CountOpen
+// the widest instruction set the processor supports is picked when the library loads, the portable
+// versions are used everywhere else; all versions produce identical results
+//
+namespace simd
+{
+
+// below this many keys the scalar loops beat the indirect call into a kernel
+const int MinVectorCount = 16;
+
+void ScaleAddKernel( int* buf, int count, int factor, int addend );
+void ExpandKernel  ( int* buf, int count, int valueCount );
+int  CountSetKernel( const uint64_t* plane, const int* positions, int count );
+int  CountRunKernel( const uint64_t* plane, int first, int count );
+
+//
+//
+//
+inline int Popcount( uint64_t w )
+{
+#if defined(__GNUC__)
+    return( __builtin_popcountll( w ) );
+#else
+    w = w - ( ( w >> 1 ) & 0x5555555555555555ULL );
+    w = ( w & 0x3333333333333333ULL ) + ( ( w >> 2 ) & 0x3333333333333333ULL );
+    w = ( w + ( w >> 4 ) ) & 0x0f0f0f0f0f0f0f0fULL;
+    return( static_cast<int>( ( w * 0x0101010101010101ULL ) >> 56 ) );
+#endif
+}
+
+//
+// Portable versions, the kernels fall back on them and short inputs never leave them
+//
+
+// buf[ i ] = buf[ i ] * factor + addend for all i < count
+inline void ScaleAddPortable( int* buf, int count, int factor, int addend )
+{
+    for( int i = 0; i < count; ++i )
+    {
+        buf[ i ] = buf[ i ] * factor + addend;
+    }
+}
+
+// replicates the first count keys valueCount times, adding 1, 2, ... to each replica
+inline void ExpandPortable( int* buf, int count, int valueCount )
+{
+    for( int addend = 1; addend < valueCount; ++addend )
+    {
+        for( int i = 0; i < count; ++i )
+        {
+            buf[ i + count * addend ] = buf[ i ] + addend;
+        }
+    }
+}
+
+// number of the given bit positions that are set in a bitplane
+inline int CountSetPortable( const uint64_t* plane, const int* positions, int count )
+{
+    int total = 0;
+    for( int i = 0; i < count; ++i )
+    {
+        total += static_cast<int>( ( plane[ positions[ i ] >> 6 ] >> ( positions[ i ] & 63 ) ) & 1 );
+    }
+    return( total );
+}
+
+// number of bits set in a run of count bits of a bitplane starting at first, a word at a time
+// with the partial words at both ends masked off
+inline int CountRunPortable( const uint64_t* plane, int first, int count )
+{
+    if( count <= 0 ) return( 0 );
+
+    int last  = first + count - 1;
+    int wLow  = first >> 6;
+    int wHigh = last  >> 6;
+    uint64_t lowMask  = ~uint64_t( 0 ) << ( first & 63 );
+    uint64_t highMask = ~uint64_t( 0 ) >> ( 63 - ( last & 63 ) );
+
+    if( wLow == wHigh )
+    {
+        return( Popcount( plane[ wLow ] & lowMask & highMask ) );
+    }
+
+    int total = Popcount( plane[ wLow ] & lowMask );
+    for( int w = wLow + 1; w < wHigh; ++w )
+    {
+        total += Popcount( plane[ w ] );
+    }
+    total += Popcount( plane[ wHigh ] & highMask );
+    return( total );
+}
+
+//
+//
+//
+inline void ScaleAdd( int* buf, int count, int factor, int addend )
+{
+    if( count >= MinVectorCount )
+    {
+        ScaleAddKernel( buf, count, factor, addend );
+    }
+    else
+    {
+        ScaleAddPortable( buf, count, factor, addend );
+    }
+}
+
+//
+//
+//
+inline void Expand( int* buf, int count, int valueCount )
+{
+    if( count >= MinVectorCount )
+    {
+        ExpandKernel( buf, count, valueCount );
+    }
+    else
+    {
+        ExpandPortable( buf, count, valueCount );
+    }
+}
+
+//
+//
+//
+inline int CountSet( const uint64_t* plane, const int* positions, int count )
+{
+    if( count >= MinVectorCount )
+    {
+        return( CountSetKernel( plane, positions, count ) );
+    }
+    return( CountSetPortable( plane, positions, count ) );
+}
+
+//
+// a run within a single word is a masked popcount, not worth the indirect call
+//
+inline int CountRun( const uint64_t* plane, int first, int count )
+{
+    if( count > 0 && ( first >> 6 ) != ( ( first + count - 1 ) >> 6 ) )
+    {
+        return( CountRunKernel( plane, first, count ) );
+    }
+    return( CountRunPortable( plane, first, count ) );
+}
+
+}
+
+}
@@ -1,5 +1,6 @@
 #include "generator.h"
 #include "deriver.h"
+using namespace std;
 
 namespace pictcore
 {
@@ -13,11 +14,8 @@ Task::Task() :
       m_rootModel     (nullptr),
       m_abortCallback (nullptr),
       m_generationMode(GenerationMode::Regular),
-      m_maxRandomTries(DefaultMaxRandomTries),
-      m_workbuf       (nullptr)
+      m_maxRandomTries(DefaultMaxRandomTries)
 {
-    Combination::ResetId();
-
 #if ( defined(_DOUT) || defined(_FILE) )
     wcerr << L"WARNING: _DOUT or _FILE are defined\n";
 #endif
@@ -32,34 +30,11 @@ Task::Task() :
 //
 Task::~Task()
 {
-    DeallocWorkbuf();
-
 #if ( defined(_DOUT) && defined(_FILE) )
     logfile.close();
 #endif
 }
 
-//
-//
-//
-void Task::AllocWorkbuf( int size )
-{
-    DeallocWorkbuf();
-    m_workbuf = new int[ size ];
-}
-
-//
-//
-//
-void Task::DeallocWorkbuf()
-{
-    if( nullptr != m_workbuf )
-    {
-        delete[] m_workbuf;
-        m_workbuf = nullptr;
-    }
-}
-
 //
 //
 //
@@ -69,8 +44,14 @@ void Task::PrepareForGeneration()
     // repropagate the task pointer to all models
     m_rootModel->WireTask(this);
 
+    // every model in the tree gets a seed derived from the root's one
+    m_rootModel->SetRandomSeed( m_rootModel->GetRandomSeed() );
+
     // run the deriver on exclusions
-    deriveExclusions();
+    if( !m_exclusionsDerived )
+    {
+        deriveExclusions();
+    }
 
     // propagate exclusions wiring to appropriate submodel
     // add each exclusion to that model in the hierarchy which is the most suitable:
@@ -88,21 +69,65 @@ void Task::PrepareForGeneration()
     m_rootModel->AddRowSeeds( m_rowSeeds.begin(), m_rowSeeds.end() );
 }
 
+//
+// Models sharing no parameters have no state in common while they are generated; each one
+// runs single-threaded and draws from its own random stream so the results are the same for
+// any number of threads. Errors are rethrown once all are done, the first model's first.
+//
+void Task::GenerateModels( vector<Model*>& models )
+{
+    if( m_workers.GetThreadCount() < 2 || models.size() < 2 )
+    {
+        for( auto model : models )
+        {
+            model->Generate();
+        }
+        return;
+    }
+
+    vector<exception_ptr> errors( models.size() );
+    for( auto model : models )
+    {
+        model->SetConcurrent( true );
+    }
+
+    m_workers.Run( static_cast<int>( models.size() ), [ & ]( int item, int ) {
+        try
+        {
+            models[ item ]->Generate();
+        }
+        catch( ... )
+        {
+            errors[ item ] = current_exception();
+        }
+    } );
+
+    for( auto model : models )
+    {
+        model->SetConcurrent( false );
+    }
+
+    for( auto & error : errors )
+    {
+        if( error ) rethrow_exception( error );
+    }
+}
+
 //
 //
 //
 void Task::ResetResultFetching()
 {
-    m_currentResultRow = m_rootModel->GetResults().begin();
+    m_currentResultRow = 0;
 }
 
 //
 //
 //
-ResultCollection::iterator Task::GetNextResultRow()
+size_t Task::GetNextResultRow()
 {
-    ResultCollection::iterator ret = m_currentResultRow;
-    if( m_currentResultRow != GetResults().end() )
+    size_t ret = m_currentResultRow;
+    if( m_currentResultRow != GetResults().GetRowCount() )
     {
         ++m_currentResultRow;
     }
@@ -162,29 +187,124 @@ bool Task::findParamInSubtree( Parameter* parameter, Model* root )
 }
 
 //
-//
+// Parameters never appearing together in an exclusion, directly or through others, can't
+// give rise to derived exclusions together. Each group of parameters tied by exclusions is
+// derived on its own, side by side with the other groups; their results are disjoint.
 //
 void Task::deriveExclusions()
 {
-    ExclusionDeriver deriver(this);
     ParamCollection params;
     m_rootModel->GetAllParameters(params);
 
+    // union-find over the parameters, linked by the exclusions they share
+    unordered_map<Parameter*, size_t> paramIndex;
     for( auto p : params )
     {
-        deriver.AddParameter( p );
+        paramIndex.insert( make_pair( p, paramIndex.size() ) );
+    }
+    for( auto & excl : m_exclusions )
+    {
+        for( auto & term : excl )
+        {
+            paramIndex.insert( make_pair( term.first, paramIndex.size() ) );
+        }
+    }
+
+    vector<size_t> parent( paramIndex.size() );
+    for( size_t n = 0; n < parent.size(); ++n )
+    {
+        parent[ n ] = n;
     }
+    auto root = [ &parent ]( size_t n ) {
+        while( parent[ n ] != n )
+        {
+            n = parent[ n ] = parent[ parent[ n ] ];
+        }
+        return( n );
+    };
 
+    // an empty exclusion makes every other one obsolete which is up to a single deriver to sort out
+    bool hasEmpty = false;
     for( auto & excl : m_exclusions )
     {
-        deriver.AddExclusion( const_cast<Exclusion&>( excl ), true );
+        if( excl.empty() )
+        {
+            hasEmpty = true;
+            continue;
+        }
+        size_t first = root( paramIndex[ excl.begin()->first ] );
+        for( auto & term : excl )
+        {
+            parent[ root( paramIndex[ term.first ] ) ] = first;
+        }
+    }
+
+    // groups are numbered in the order their first parameter comes in
+    vector<unique_ptr<ExclusionDeriver>> derivers;
+    unordered_map<size_t, size_t> groupOf;
+    auto deriverOf = [ & ]( size_t group ) {
+        auto ig = groupOf.insert( make_pair( group, derivers.size() ) );
+        if( ig.second )
+        {
+            derivers.push_back( unique_ptr<ExclusionDeriver>( new ExclusionDeriver( this ) ) );
+        }
+        return( ig.first->second );
+    };
+    for( auto p : params )
+    {
+        derivers[ deriverOf( hasEmpty ? 0 : root( paramIndex[ p ] ) ) ]->AddParameter( p );
+    }
+
+    // groups without exclusions have nothing to derive
+    vector<ExclusionDeriver*> active;
+    vector<char> isActive;
+    for( auto & excl : m_exclusions )
+    {
+        size_t index = deriverOf( hasEmpty ? 0 : root( paramIndex[ excl.begin()->first ] ) );
+        isActive.resize( derivers.size(), 0 );
+        if( !isActive[ index ] )
+        {
+            isActive[ index ] = 1;
+            active.push_back( derivers[ index ].get() );
+        }
+        derivers[ index ]->AddExclusion( const_cast<Exclusion&>( excl ), true );
+    }
+
+    vector<exception_ptr> errors( active.size() );
+    auto derive = [ & ]( int item, int ) {
+        try
+        {
+            active[ item ]->DeriveExclusions();
+        }
+        catch( ... )
+        {
+            errors[ item ] = current_exception();
+        }
+    };
+    if( m_workers.GetThreadCount() < 2 || active.size() < 2 )
+    {
+        for( int item = 0; item < static_cast<int>( active.size() ); ++item )
+        {
+            derive( item, 0 );
+            if( errors[ item ] ) break;
+        }
+    }
+    else
+    {
+        m_workers.Run( static_cast<int>( active.size() ), derive );
+    }
+
+    for( auto & error : errors )
+    {
+        if( error ) rethrow_exception( error );
     }
 
-    deriver.DeriveExclusions();
-    
     // must clear and repopulate the collection with the result of the derivation
     m_exclusions.clear();
-    __insert( m_exclusions, deriver.GetExclusions().begin(), deriver.GetExclusions().end() );
+    for( auto deriver : active )
+    {
+        __insert( m_exclusions, deriver->GetExclusions().begin(), deriver->GetExclusions().end() );
+    }
 }
 
 }
@@ -1,94 +1,99 @@
 // ------------------------------------------------------------------------------
 // Simplified trie; not thread-safe
+// Sequences are inserted and looked up in ascending order of Less
 // ------------------------------------------------------------------------------
 #pragma once
 
-#include <map>
+#include <vector>
+#include <functional>
+#include <new>
 
 //
-//
+// nodes live in one array and refer to each other by index; the children of a node
+// form a list kept in ascending order of their items
 //
 template <class Item>
 class trienode
 {
 public:
-    typedef std::map< Item, trienode<Item>* > TNodes;
-
-    TNodes children;
-    bool   valid;
+    static const int none = -1;
 
-    trienode() : valid( false ) {}
+    Item item;
+    int  child;
+    int  sibling;
+    bool valid;
 
-    ~trienode()
-    {
-        for( typename TNodes::iterator ii = children.begin(); ii != children.end(); ++ii )
-        {
-            delete ii->second;
-        }
-    }
+    trienode() : item(), child( none ), sibling( none ), valid( false ) {}
+    explicit trienode( const Item& i ) : item( i ), child( none ), sibling( none ), valid( false ) {}
 };
 
 //
 //
 //
-template <class Col>
+template <class Item, class Less = std::less<Item> >
 class trie
 {
-    typedef typename trienode<typename Col::value_type>::TNodes TNodeCol;
-
 public:
-    //
-    //
-    //
-    trie()
-    {
-        m_root = new trienode<typename Col::value_type>;
-    }
+    typedef trienode<Item> node;
 
     //
     //
     //
-    ~trie()
+    trie()
     {
-        delete m_root;
+        m_nodes.push_back( node() );
     }
 
     //
     //
     //
-    trienode<typename Col::value_type>* get_root() { return m_root; }
+    const node& get_root() const { return m_nodes[ 0 ]; }
+    const node& get_node( int index ) const { return m_nodes[ index ]; }
 
     //
     // returns false if insert failed (OutOfMemory)
     //
-    bool insert( Col &t )
+    template <class Iter>
+    bool insert( Iter first, Iter last )
     {
-        trienode<typename Col::value_type>* current = m_root;
-        for( typename Col::iterator ic = t.begin(); ic != t.end(); ++ic )
+        int current = 0;
+        for( ; first != last; ++first )
         {
-            typename TNodeCol::iterator found;
-            found = current->children.find( *ic );
-            if( found == current->children.end() )
+            // find the child or the place to link a new one in
+            int prev  = node::none;
+            int child = m_nodes[ current ].child;
+            while( child != node::none && m_less( m_nodes[ child ].item, *first ) )
             {
-                trienode< typename Col::value_type > *node = nullptr;
+                prev  = child;
+                child = m_nodes[ child ].sibling;
+            }
 
+            if( child == node::none || m_less( *first, m_nodes[ child ].item ) )
+            {
                 try
                 {
-                    node = new trienode < typename Col::value_type >;
+                    m_nodes.push_back( node( *first ) );
                 }
-                catch(const std::bad_alloc& )
+                catch( const std::bad_alloc& )
                 {
                     return( false );
                 }
 
-                std::pair<typename TNodeCol::iterator, bool> ret = current->children.insert( make_pair( *ic, node ) );
-                if( !ret.second ) return( false );
-
-                found = ret.first;
+                int added = static_cast<int>( m_nodes.size() ) - 1;
+                m_nodes[ added ].sibling = child;
+                if( prev == node::none )
+                {
+                    m_nodes[ current ].child = added;
+                }
+                else
+                {
+                    m_nodes[ prev ].sibling = added;
+                }
+                child = added;
             }
-            current = found->second;
+            current = child;
         }
-        current->valid = true;
+        m_nodes[ current ].valid = true;
 
         return( true );
     }
@@ -96,59 +101,74 @@ public:
     //
     // trienodes are not deallocated when an element is erased
     // this is for perf reasons; memory usage is not that important
-    // the whole structure will be torn down in d'tor
+    // the whole structure goes away with the trie
     //
-    void erase( Col& t )
+    template <class Iter>
+    void erase( Iter first, Iter last )
     {
-        trienode<typename Col::value_type>* node = pfind( t );
-        if( nullptr == node ) return;
-        node->valid = false;
+        int current = 0;
+        for( ; first != last; ++first )
+        {
+            current = find_child( current, *first );
+            if( current == node::none ) return;
+        }
+        m_nodes[ current ].valid = false;
     }
 
     //
+    // returns true if any of the sequences in the trie is a subset of the given one
     //
-    //
-    bool find_prefix( Col &t )
+    template <class Iter>
+    bool find_subset( Iter first, Iter last ) const
     {
-        return( pfind_prefix( t ) != nullptr );
+        return( pfind_subset( 0, first, last ) );
     }
 
 private:
-    trienode<typename Col::value_type>* m_root;
+    std::vector<node> m_nodes;
+    Less              m_less;
 
     //
     //
     //
-    trienode<typename Col::value_type>* pfind( Col &t )
+    int find_child( int parent, const Item& item ) const
     {
-        trienode<typename Col::value_type> *current = m_root;
-        for( typename Col::iterator ic = t.begin(); ic != t.end(); ++ic )
+        for( int child = m_nodes[ parent ].child; child != node::none; child = m_nodes[ child ].sibling )
         {
-            typename TNodeCol::iterator found = current->children.find( *ic );
-            if( found == current->children.end() ) return( nullptr );
-
-            current = found->second;
+            if( m_less( item, m_nodes[ child ].item ) ) break;
+            if( !m_less( m_nodes[ child ].item, item ) ) return( child );
         }
-        return( current->valid ? current : nullptr );
+        return( node::none );
     }
 
     //
+    // walks the children and the rest of the sequence side by side, both are sorted so
+    // neither is ever stepped back; only children matching an item are descended into
     //
-    //
-    trienode<typename Col::value_type>* pfind_prefix( Col &t )
+    template <class Iter>
+    bool pfind_subset( int current, Iter first, Iter last ) const
     {
-        trienode<typename Col::value_type> *current = m_root;
-        for( typename Col::iterator ic = t.begin(); ic != t.end(); ++ic )
-        {
-            typename TNodeCol::iterator found = current->children.find( *ic );
-            if( found == current->children.end() ) return( nullptr );
-
-            current = found->second;
+        if( m_nodes[ current ].valid ) return( true );
 
-            if( current->valid ) return( current );
+        int child = m_nodes[ current ].child;
+        while( child != node::none && first != last )
+        {
+            if( m_less( m_nodes[ child ].item, *first ) )
+            {
+                child = m_nodes[ child ].sibling;
+            }
+            else if( m_less( *first, m_nodes[ child ].item ) )
+            {
+                ++first;
+            }
+            else
+            {
+                Iter next = first;
+                if( pfind_subset( child, ++next, last ) ) return( true );
+                child = m_nodes[ child ].sibling;
+                first = next;
+            }
         }
-
-        return( current->valid ? current : nullptr );
+        return( false );
     }
 };
-
@@ -0,0 +1,116 @@
+#include "generator.h"
+using namespace std;
+
+namespace pictcore
+{
+
+//
+// Slot 0 belongs to the thread calling Run, helper threads take the remaining ones;
+//  if the system won't create any more threads the pool runs with the ones it has
+//
+void WorkerPool::Start( int threadCount )
+{
+    Stop();
+    m_threads.reserve( max( 0, threadCount - 1 ) );
+    for( int slot = 1; slot < threadCount; ++slot )
+    {
+        try
+        {
+            m_threads.push_back( thread( &WorkerPool::worker, this, slot ) );
+        }
+        catch( const system_error& )
+        {
+            break;
+        }
+    }
+    m_threadCount = static_cast<int>( m_threads.size() ) + 1;
+}
+
+//
+//
+//
+void WorkerPool::Stop()
+{
+    {
+        lock_guard<mutex> lock( m_mutex );
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for( auto & t : m_threads )
+    {
+        t.join();
+    }
+    m_threads.clear();
+    m_threadCount = 1;
+    m_stopping = false;
+}
+
+//
+//
+//
+void WorkerPool::Run( int count, const Job& job )
+{
+    if( m_threads.empty() || count < 2 )
+    {
+        for( int item = 0; item < count; ++item )
+        {
+            job( item, 0 );
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock( m_mutex );
+        m_job       = &job;
+        m_itemCount = count;
+        m_nextItem  = 0;
+        m_busy      = static_cast<int>( m_threads.size() );
+        ++m_batch;
+    }
+    m_wake.notify_all();
+
+    work( 0 );
+
+    unique_lock<mutex> lock( m_mutex );
+    m_done.wait( lock, [ this ] { return( 0 == m_busy ); } );
+    m_job = nullptr;
+}
+
+//
+//
+//
+void WorkerPool::worker( int slot )
+{
+    unsigned int seen = 0;
+    for( ;; )
+    {
+        {
+            unique_lock<mutex> lock( m_mutex );
+            m_wake.wait( lock, [ this, seen ] { return( m_stopping || m_batch != seen ); } );
+            if( m_stopping ) return;
+            seen = m_batch;
+        }
+
+        work( slot );
+
+        lock_guard<mutex> lock( m_mutex );
+        if( 0 == --m_busy )
+        {
+            m_done.notify_one();
+        }
+    }
+}
+
+//
+// Items are handed out one at a time so uneven items still spread evenly
+//
+void WorkerPool::work( int slot )
+{
+    for( int item = m_nextItem++; item < m_itemCount; item = m_nextItem++ )
+    {
+        ( *m_job )( item, slot );
+    }
+}
+
+}
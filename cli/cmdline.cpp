@@ -1,5 +1,6 @@
 #include <iostream>
 #include <ctime>
+#include <thread>
 #include "cmdline.h"
 using namespace std;
 
@@ -23,10 +24,11 @@ unsigned int getUIntFromArg( wchar_t* text )
         return( 0 );
     }
 
-    int i = static_cast<int>( number );
-    if( i < 0 ) i = 0;
+    // seeds take the whole unsigned range, a cast through int would lose the upper half
+    if( number < 0 ) return( 0 );
+    if( number > numeric_limits< unsigned int >::max() ) return( numeric_limits< unsigned int >::max() );
 
-    return ( static_cast<unsigned int> ( i ) );
+    return ( static_cast<unsigned int> ( number ) );
 }
 
 //
@@ -181,7 +183,7 @@ bool parseArg( wchar_t* text, CModelData& modelData )
         // /r
         if( wcslen( text ) == 2 )
         {
-            modelData.RandSeed = (unsigned short) ( time( nullptr ) );
+            modelData.RandSeed = (unsigned int) ( time( nullptr ) );
         }
         // /r:
         else if( wcslen( text ) == 3 )
@@ -193,7 +195,7 @@ bool parseArg( wchar_t* text, CModelData& modelData )
         else
         {
             unsigned int i = getUIntFromArg( text );
-            modelData.RandSeed = (unsigned short) i;
+            modelData.RandSeed = i;
         }
         break;
     }
@@ -210,6 +212,32 @@ bool parseArg( wchar_t* text, CModelData& modelData )
         }
         break;
     }
+    case SWITCH_COMPACT:
+    {
+        if( wcslen( text ) == 2 )
+        {
+            modelData.CompactResults = true;
+        }
+        else
+        {
+            unknownOption = true;
+            break;
+        }
+        break;
+    }
+    case SWITCH_LAZY:
+    {
+        if( wcslen( text ) == 2 )
+        {
+            modelData.LazyConstraints = true;
+        }
+        else
+        {
+            unknownOption = true;
+            break;
+        }
+        break;
+    }
     case SWITCH_STATISTICS:
     {
         if( wcslen( text ) == 2 )
@@ -284,6 +312,46 @@ bool parseArg( wchar_t* text, CModelData& modelData )
         }
         break;
     }
+    case SWITCH_THREADS:
+    {
+        unsigned int i = getUIntFromArg( text );
+        if( i == 0 )
+        {
+            unknownOption = true;
+            break;
+        }
+
+        // threads beyond what the machine runs at once gain nothing and results don't depend on them
+        unsigned int hardwareThreads = thread::hardware_concurrency();
+        if( hardwareThreads > 0 && i > hardwareThreads )
+        {
+            i = hardwareThreads;
+        }
+        modelData.ThreadCount = i;
+        break;
+    }
+    case SWITCH_CANDIDATES:
+    {
+        unsigned int i = getUIntFromArg( text );
+        if( i == 0 )
+        {
+            unknownOption = true;
+            break;
+        }
+        modelData.CandidateCount = i;
+        break;
+    }
+    case SWITCH_PORTFOLIO:
+    {
+        unsigned int i = getUIntFromArg( text );
+        if( i == 0 )
+        {
+            unknownOption = true;
+            break;
+        }
+        modelData.PortfolioSize = i;
+        break;
+    }
     default:
     {
         unknownOption = true;
@@ -319,6 +387,11 @@ void showUsage()
     wcout << L" /" << charToStr( SWITCH_SEED_FILE )         << L":file          - File with seeding rows"             << endl;
     wcout << L" /" << charToStr( SWITCH_RANDOMIZE )         << L"[:N]           - Randomize generation, N - seed"     << endl;
     wcout << L" /" << charToStr( SWITCH_FORMAT )            << L"[:text|json]   - Output format (default: text)"      << endl;
+    wcout << L" /" << charToStr( SWITCH_THREADS )           << L":N             - Worker threads (default: 1)"        << endl;
+    wcout << L" /" << charToStr( SWITCH_CANDIDATES )        << L":N             - Best of N candidate rows (default: 1)" << endl;
+    wcout << L" /" << charToStr( SWITCH_PORTFOLIO )         << L":N             - Smallest of N generations, seeds from /r on" << endl;
+    wcout << L" /" << charToStr( SWITCH_COMPACT )           << L"               - Remove rows adding no coverage"     << endl;
+    wcout << L" /" << charToStr( SWITCH_LAZY )              << L"               - Check constraints while building rows" << endl;
     wcout << L" /" << charToStr( SWITCH_CASE_SENSITIVE )    << L"               - Case-sensitive model evaluation"    << endl;
     wcout << L" /" << charToStr( SWITCH_STATISTICS )        << L"               - Show model statistics"              << endl;
     // there are hidden parameters:
@@ -361,5 +434,19 @@ bool ParseArgs
         ii++;
     }
 
+    // candidate rows are built without the constraint solver, lazy constraints build rows one at a time
+    if( modelData.CandidateCount > 1 && modelData.LazyConstraints )
+    {
+        PrintMessage( InputDataError, L"Options /b and /l cannot be used together" );
+        return( false );
+    }
+
+    // candidates of a portfolio take the seeds following the given one, all of them must be seeds
+    if( modelData.PortfolioSize - 1 > numeric_limits< unsigned int >::max() - modelData.RandSeed )
+    {
+        PrintMessage( InputDataError, L"Portfolio needs seeds past the largest one, use a smaller /k or /r:N" );
+        return( false );
+    }
+
     return( true );
 }
@@ -22,6 +22,11 @@ const wchar_t SWITCH_VERBOSE         = L'v';
 const wchar_t SWITCH_PREVIEW         = L'p';
 const wchar_t SWITCH_APPROXIMATE     = L'x';
 const wchar_t SWITCH_FORMAT          = L'f';
+const wchar_t SWITCH_THREADS         = L't';
+const wchar_t SWITCH_CANDIDATES      = L'b';
+const wchar_t SWITCH_PORTFOLIO       = L'k';
+const wchar_t SWITCH_COMPACT         = L'm';
+const wchar_t SWITCH_LAZY            = L'l';
 
 //
 //
@@ -1,3 +1,6 @@
+#include <thread>
+#include <mutex>
+#include "cmdline.h"
 #include "gcd.h"
 using namespace std;
 
@@ -7,57 +10,175 @@ namespace pictcli_gcd
 {
 
 //
+// turns value indexes into value names
+//
+CRow translateRow( IN CModelData& modelData, IN const vector< size_t >& values )
+{
+    bool isNegativeTestCase = false;
+
+    wstrings rowText, decoratedRowText;
+    for( size_t pindex = 0; pindex < values.size(); ++pindex )
+    {
+        auto vindex = values[ pindex ];
+        wstring name, decoratedName;
+        if( Parameter::UndefinedValue == vindex )
+        {
+            name = decoratedName = L"?";
+        }
+        else
+        {
+            CModelValue& value = modelData.Parameters[ pindex ].Values[ vindex ];
+
+            if( !value.IsPositive() )
+            {
+                decoratedName = charToStr( modelData.InvalidPrefix );
+                isNegativeTestCase = true;
+            }
+            name = value.GetNextName();
+            decoratedName += name;
+        }
+        rowText.push_back( name );
+        decoratedRowText.push_back( decoratedName );
+    }
+
+    return( CRow( rowText, decoratedRowText, isNegativeTestCase ) );
+}
+
 //
 //
-ErrorCode GcdRunner::generateResults( IN CModelData& modelData, IN bool justNegative )
+//
+void CRowStreamer::WriteRow( const vector< size_t >& values )
 {
-    // translate all data to gcd-readable format, build exclusions etc.
-    CGcdData gcdData( modelData );
-    ErrorCode err = gcdData.TranslateToGCD();
-    if( FAILED( err )) return( err );
+    if( !_begun ) begin();
+
+    CRow testCase = translateRow( _modelData, values );
+    _writer.Write( testCase );
+}
+
+//
+//
+//
+void CRowStreamer::End()
+{
+    if( !_begun ) begin();
+
+    _writer.End();
+}
+
+//
+//
+//
+void CRowStreamer::begin()
+{
+    _modelData.PrintUsedSeed();
+    _result.PrintConstraintWarnings();
+    _writer.Begin();
+    _begun = true;
+}
+
+//
+// translate all data to gcd-readable format, build exclusions etc.
+//
+ErrorCode GcdRunner::translateModel( IN CGcdRun& run, IN ConstraintsInterpreter& constraints )
+{
+    return( run.GcdData.TranslateToGCD( constraints ));
+}
+
+//
+//
+//
+void GcdRunner::deriveExclusions( IN CGcdRun& run )
+{
+    try
+    {
+        run.GcdData.DeriveExclusions();
+    }
+    catch( ... )
+    {
+        run.Failure = current_exception();
+    }
+}
+
+//
+//
+//
+ErrorCode GcdRunner::checkExclusions( IN CGcdRun& run )
+{
+    if( run.Failure ) rethrow_exception( run.Failure );
 
     // check if we excluded all values of any parameter; generation will return nothing if that's the case
-    if( gcdData.CheckEntireParameterExcluded() )
+    if( run.GcdData.CheckEntireParameterExcluded() )
     {
         return( ErrorCode::ErrorCode_BadConstraints );
     }
 
     // save all one-element exclusions, they'll be used for warnings later
-    _result.SolverWarnings       = gcdData.GetConstraintWarnings();
-    _result.SingleItemExclusions = gcdData.GetSingleItemExclusions();
+    _result.SolverWarnings       = run.GcdData.GetConstraintWarnings();
+    _result.SingleItemExclusions = run.GcdData.GetSingleItemExclusions();
 
-    if( modelData.Verbose )
+    if( run.ModelData.Verbose )
     {
-        modelData.PrintModelContents( L"*** AFTER MODEL IS PARSED ***" );
+        run.ModelData.PrintModelContents( L"*** AFTER MODEL IS PARSED ***" );
     }
 
+    return( ErrorCode::ErrorCode_Success );
+}
+
+//
+// Nothing gets printed here unless in the verbose mode, errors are reported by collectResults
+//
+void GcdRunner::runEngine( IN CGcdRun& run )
+{
+    CModelData& modelData = run.ModelData;
+
     // run the generation from bottom up
-    Model* model = gcdData.GetRootModel();
+    Model* model = run.GcdData.GetRootModel();
     model->SetRandomSeed( modelData.RandSeed );
+
     try
     {
-        for( auto & submodel : model->GetSubmodels() )
+        // submodels sharing no parameters are generated side by side
+        vector< vector< Model* > > waves;
+        model->GetSubmodelWaves( waves );
+
+        // the log shows each submodel's order as if it was fixed for that submodel alone, in the
+        // order of the submodels; the log of one waits until all before it have been generated
+        SubmodelCollection& submodels = model->GetSubmodels();
+        SubmodelCollection::iterator logged = submodels.begin();
+        set< Model* > generated;
+
+        for( auto & wave : waves )
         {
             // each submodel may assign different order to parameters
-            if( !gcdData.FixParamOrder( submodel ))
+            if( !run.GcdData.FixParamOrder( wave ))
             {
-                return( ErrorCode::ErrorCode_BadModel );
+                run.Error = ErrorCode::ErrorCode_BadModel;
+                return;
             }
 
-            if( modelData.Verbose )
+            model->GetTask()->GenerateModels( wave );
+
+            for( auto & submodel : wave )
             {
-                modelData.PrintModelContents( L"*** AFTER ORDER IS FIXED ***" );
+                modelData.AddToTotalCombinationsCount( submodel->GetTotalCombinationsCount() );
+                modelData.AddToRemainingCombinationsCount( submodel->GetRemainingCombinationsCount() );
             }
 
-            submodel->Generate();
-        
-            modelData.AddToTotalCombinationsCount( submodel->GetTotalCombinationsCount() );
-            modelData.AddToRemainingCombinationsCount( submodel->GetRemainingCombinationsCount() );
+            if( modelData.Verbose )
+            {
+                generated.insert( wave.begin(), wave.end() );
+                for( ; logged != submodels.end() && generated.find( *logged ) != generated.end(); ++logged )
+                {
+                    run.GcdData.FixParamOrder( *logged );
+                    modelData.PrintModelContents( L"*** AFTER ORDER IS FIXED ***" );
+                }
+            }
         }
 
-        if( !gcdData.FixParamOrder( model ))
+        if( !run.GcdData.FixParamOrder( model ))
         {
-            return( ErrorCode::ErrorCode_BadModel );
+            run.Error = ErrorCode::ErrorCode_BadModel;
+            return;
         }
 
         if( modelData.Verbose )
@@ -75,8 +196,32 @@ ErrorCode GcdRunner::generateResults( IN CModelData& modelData, IN bool justNega
             modelData.PrintModelContents( L"*** AFTER GENERATION ***" );
         }
     }
+    catch( ... )
+    {
+        run.Failure = current_exception();
+    }
+}
+
+//
+//
+//
+ErrorCode GcdRunner::collectResults( IN CGcdRun& run )
+{
+    if( FAILED( run.Error )) return( run.Error );
+
+    try
+    {
+        if( run.Failure ) rethrow_exception( run.Failure );
+    }
     catch( GenerationError e )
     {
+        // with lazy constraints this is where unsatisfiable ones show up, it's not an internal error
+        if( ErrorType::TooRestrictive == e.GetErrorType() )
+        {
+            PrintMessage( InputDataError, L"Too restrictive constraints. No test case satisfies all of them." );
+            return( ErrorCode::ErrorCode_BadConstraints );
+        }
+
         switch( e.GetErrorType() )
         {
         case ErrorType::OutOfMemory:
@@ -86,6 +231,7 @@ ErrorCode GcdRunner::generateResults( IN CModelData& modelData, IN bool justNega
         case ErrorType::TooManyRows:         // not used in PICT.EXE
         case ErrorType::Unknown:
         case ErrorType::GenerationFailure:
+        case ErrorType::TooRestrictive:
             wstring msg = L"Internal error\n";
             msg += L"As a workaround run the tool with parameter /r a few times and see if any of the iterations produces a result.\n";
             msg += L"If the result is produced, it is guaranteed to be valid and it is safe to use.";
@@ -99,50 +245,111 @@ ErrorCode GcdRunner::generateResults( IN CModelData& modelData, IN bool justNega
         return( ErrorCode::ErrorCode_GenerationError );
     }
 
-    translateResults( modelData, model->GetResults(), justNegative );
+#ifdef _DEBUG
+    // the rows checked once more, on the constraints themselves rather than the exclusions
+    ResultTable& results = run.GcdData.GetRootModel()->GetResults();
+    vector< int > values( results.GetColumnCount() );
+    for( size_t row = 0; row < results.GetRowCount(); ++row )
+    {
+        for( size_t pindex = 0; pindex < results.GetColumnCount(); ++pindex )
+        {
+            size_t vindex = results.Get( row, pindex );
+            values[ pindex ] = Parameter::UndefinedValue == vindex ? -1 : static_cast< int >( vindex );
+        }
+        assert( !run.GcdData.Predicate.Violates( values ));
+    }
+#endif
+
+    translateResults( run.ModelData, run.GcdData.GetRootModel()->GetResults(), run.JustNegative );
 
     return( ErrorCode::ErrorCode_Success );
 }
 
 //
+// the run either has an error to report or an exception to rethrow
 //
+bool failed( IN CGcdRun& run )
+{
+    return( FAILED( run.Error ) || run.Failure );
+}
+
 //
-void GcdRunner::translateResults( IN CModelData&       modelData,
-                                  IN ResultCollection& resultCollection,
-                                  IN bool              justNegative )
+// rows the run adds to the result
+//
+size_t countRows( IN CGcdRun& run )
 {
-    for( auto & row : resultCollection )
+    ResultTable& results = run.GcdData.GetRootModel()->GetResults();
+    if( !run.JustNegative ) return( results.GetRowCount() );
+
+    size_t count = 0;
+    for( size_t row = 0; row < results.GetRowCount(); ++row )
     {
-        bool isNegativeTestCase = false;
-        
-        wstrings rowText, decoratedRowText;
-        for( size_t pindex = 0; pindex < row.size(); ++pindex )
+        for( size_t pindex = 0; pindex < results.GetColumnCount(); ++pindex )
         {
-            auto vindex = row[ pindex ];
-            wstring name, decoratedName;
-            if( Parameter::UndefinedValue == vindex )
+            auto vindex = results.Get( row, pindex );
+            if( Parameter::UndefinedValue != vindex
+             && !run.ModelData.Parameters[ pindex ].Values[ vindex ].IsPositive() )
             {
-                name = decoratedName = L"?";
+                ++count;
+                break;
             }
-            else
-            {
-                CModelValue& value = modelData.Parameters[ pindex ].Values[ vindex ];
+        }
+    }
+    return( count );
+}
 
-                if( !value.IsPositive() )
-                {
-                    decoratedName = charToStr( modelData.InvalidPrefix );
-                    isNegativeTestCase = true;
-                }
-                name = value.GetNextName();
-                decoratedName += name;
-            }
-            rowText.push_back( name );
-            decoratedRowText.push_back( decoratedName );
+//
+// all steps of a single run one after another
+//
+ErrorCode GcdRunner::generateResults( IN CGcdRun& run, IN ConstraintsInterpreter& constraints, IN bool allowStreaming )
+{
+    ErrorCode err = translateModel( run, constraints );
+    if( FAILED( err )) return( err );
+
+    deriveExclusions( run );
+
+    err = checkExclusions( run );
+    if( FAILED( err )) return( err );
+
+    // rows of a flat model don't have to wait for the generation to finish
+    Model* model = run.GcdData.GetRootModel();
+    unique_ptr< CRowStreamer > streamer;
+    if( allowStreaming && model->CanStreamRows() )
+    {
+        streamer.reset( new CRowStreamer( run.ModelData, _result, *_output ) );
+        model->SetRowSink( streamer.get() );
+        _streamed = true;
+    }
+
+    runEngine( run );
+
+    model->SetRowSink( nullptr );
+    if( streamer && !FAILED( run.Error ) && !run.Failure )
+    {
+        streamer->End();
+    }
+
+    return( collectResults( run ));
+}
+
+//
+//
+//
+void GcdRunner::translateResults( IN CModelData&       modelData,
+                                  IN ResultTable&      results,
+                                  IN bool              justNegative )
+{
+    vector< size_t > values( results.GetColumnCount() );
+    for( size_t row = 0; row < results.GetRowCount(); ++row )
+    {
+        for( size_t pindex = 0; pindex < results.GetColumnCount(); ++pindex )
+        {
+            values[ pindex ] = results.Get( row, pindex );
         }
 
-        if( !justNegative || ( justNegative && isNegativeTestCase ))
+        CRow testCase = translateRow( modelData, values );
+        if( !justNegative || ( justNegative && testCase.Negative ))
         {
-            CRow testCase( rowText, decoratedRowText, isNegativeTestCase );
             _result.TestCases.push_back( testCase );
         }
     }
@@ -158,28 +365,208 @@ ErrorCode GcdRunner::Generate()
     // make a copy
     CModelData modelData2 = _modelData;
 
+    // rows can only be written out as they come when there's a single run and nothing else to print
+    bool allowStreaming = nullptr != _output
+                       && 1 == _modelData.PortfolioSize
+                       && !_modelData.HasNegativeValues()
+                       && !_modelData.Statistics
+                       && !_modelData.Verbose;
+
     // the "positive" run; remove all negative values 
     if( _modelData.HasNegativeValues() )
     {
         _modelData.RemoveNegativeValues();
     }
 
-    ErrorCode err = generateResults( _modelData, false );
-    if( FAILED( err )) return( err );
+    // the constraints are only parsed once, the "negative" run reuses them unless
+    // the invalid values changed the type of any parameter
+    ConstraintsInterpreter constraints;
 
-    // the "negative" run; only if any negative values exist
-    if( modelData2.HasNegativeValues() )
+    // a single run, or two that go one after another so that their verbose output doesn't interleave
+    if( 1 == _modelData.PortfolioSize && ( !modelData2.HasNegativeValues() || _modelData.Verbose ))
     {
+        CGcdRun positive( _modelData, false );
+        ErrorCode err = generateResults( positive, constraints, allowStreaming );
+        if( FAILED( err ) || !modelData2.HasNegativeValues() ) return( err );
+
         // if negative values exist then positive run may have already warned about 
         // non-existing problems with the constraints, discard the set of warnings
         // as a new one will be produced and we don't want any dupliactes
         _result.SolverWarnings.clear();
         _result.SingleItemExclusions.clear();
 
-        err = generateResults( modelData2, true );
+        // the "negative" run; only if any negative values exist
+        ConstraintsInterpreter negativeConstraints;
+        CGcdRun negative( modelData2, true );
+        return( generateResults( negative, constraints.CanConvert( modelData2 ) ? constraints : negativeConstraints, false ));
+    }
+
+    return( generateSideBySide( modelData2, constraints ));
+}
+
+//
+// a candidate's runs take over the exclusions the variants of the model derived; given a thread
+// for each they go side by side, otherwise one after another and only until one of them fails
+//
+unique_ptr< CGcdCandidate > GcdRunner::runCandidate( IN unsigned int index,
+                                                     IN vector< unique_ptr< CGcdRun >>& variants,
+                                                     IN unsigned int threadCount,
+                                                     IN unsigned int variantThreads )
+{
+    unique_ptr< CGcdCandidate > candidate( new CGcdCandidate( index ));
+    for( auto & variant : variants )
+    {
+        candidate->Models.push_back( variant->ModelData );
+        CModelData& modelData = candidate->Models.back();
+        modelData.RandSeed    = variant->ModelData.RandSeed + index;
+        modelData.ThreadCount = threadCount;
+
+        candidate->Runs.emplace_back( new CGcdRun( modelData, variant->JustNegative ));
+    }
+
+    WorkerPool workers;
+    workers.Start( static_cast< int >( variantThreads ));
+    workers.Run( static_cast< int >( variants.size() ), [ & ]( int item, int )
+    {
+        for( int prior = 0; 1 == workers.GetThreadCount() && prior < item; ++prior )
+        {
+            if( failed( *candidate->Runs[ prior ] )) return;
+        }
+
+        CGcdRun& run = *candidate->Runs[ item ];
+        try
+        {
+            run.Error = run.GcdData.TranslateToGCD( variants[ item ]->GcdData );
+        }
+        catch( ... )
+        {
+            run.Failure = current_exception();
+        }
+
+        if( !failed( run ))
+        {
+            runEngine( run );
+        }
+    } );
+    workers.Stop();
+
+    for( auto & run : candidate->Runs )
+    {
+        if( failed( *run ))
+        {
+            candidate->Failed = true;
+            break;
+        }
+        candidate->Rows += countRows( *run );
+    }
+
+    return( candidate );
+}
+
+//
+// Each candidate is a "positive" run and a "negative" one if there are any negative values,
+// candidates of a portfolio only differ in their seeds. The exclusions don't depend on the seed so
+// each variant of the model is translated and derived once and all the candidates share the result.
+// Candidates run side by side on as many threads as /t gives, or the machine runs at once if it's
+// not given; only the smallest result so far is kept
+//
+ErrorCode GcdRunner::generateSideBySide( IN CModelData& negativeModelData, IN ConstraintsInterpreter& constraints )
+{
+    vector< unique_ptr< CGcdRun >> variants;
+    variants.emplace_back( new CGcdRun( _modelData, false ));
+    if( negativeModelData.HasNegativeValues() )
+    {
+        variants.emplace_back( new CGcdRun( negativeModelData, true ));
+    }
+
+    ConstraintsInterpreter negativeConstraints;
+    for( auto & variant : variants )
+    {
+        ErrorCode err = translateModel( *variant, constraints.CanConvert( variant->ModelData ) ? constraints : negativeConstraints );
         if( FAILED( err )) return( err );
     }
 
+    // the derivations are independent, in the verbose mode they go one after another so that
+    // their logs don't interleave
+    unsigned int variantThreads = _modelData.Verbose ? 1 : static_cast< unsigned int >( variants.size() );
+    {
+        WorkerPool workers;
+        workers.Start( static_cast< int >( variantThreads ));
+        workers.Run( static_cast< int >( variants.size() ), [ & ]( int item, int )
+        {
+            deriveExclusions( *variants[ item ] );
+        } );
+        workers.Stop();
+    }
+
+    for( auto & variant : variants )
+    {
+        // each run produces its own set of warnings, only the last one is kept
+        _result.SolverWarnings.clear();
+        _result.SingleItemExclusions.clear();
+
+        ErrorCode err = checkExclusions( *variant );
+        if( FAILED( err )) return( err );
+    }
+
+    unsigned int threadCount = _modelData.ThreadCount;
+    if( _modelData.ProvidedArguments.find( SWITCH_THREADS ) == _modelData.ProvidedArguments.end() )
+    {
+        threadCount = max( 1u, thread::hardware_concurrency() );
+    }
+
+    // verbose output would interleave so in that case the candidates go one after another;
+    // the engine only gets the threads when the candidates don't take them
+    unsigned int candidateThreads = _modelData.Verbose ? 1 : min( threadCount, _modelData.PortfolioSize );
+    unsigned int engineThreads    = candidateThreads > 1 ? 1 : _modelData.ThreadCount;
+
+    // without a portfolio the only candidate runs its variants side by side
+    if( _modelData.PortfolioSize > 1 ) variantThreads = 1;
+
+    // the fewest rows win and a tie goes to the lower seed, so the winner doesn't depend on the
+    // order the candidates finish in; candidates that fail are passed over but if none gets
+    // through, the first one gets to report its failure
+    unique_ptr< CGcdCandidate > winner;
+    unique_ptr< CGcdCandidate > first;
+    mutex                       winnerLock;
+
+    WorkerPool workers;
+    workers.Start( static_cast< int >( candidateThreads ));
+    workers.Run( static_cast< int >( _modelData.PortfolioSize ), [ & ]( int item, int )
+    {
+        unique_ptr< CGcdCandidate > candidate = runCandidate( static_cast< unsigned int >( item ), variants, engineThreads, variantThreads );
+
+        lock_guard< mutex > lock( winnerLock );
+        if( candidate->Failed )
+        {
+            if( 0 == candidate->Index )
+            {
+                first = move( candidate );
+            }
+        }
+        else if( !winner
+              || candidate->Rows < winner->Rows
+              || ( candidate->Rows == winner->Rows && candidate->Index < winner->Index ))
+        {
+            winner = move( candidate );
+        }
+    } );
+    workers.Stop();
+
+    if( !winner )
+    {
+        winner = move( first );
+    }
+
+    for( auto & run : winner->Runs )
+    {
+        ErrorCode err = collectResults( *run );
+        if( FAILED( err )) return( err );
+    }
+
+    // statistics and the seed reported come from the winner
+    _modelData = winner->Runs.front()->ModelData;
+
     return( ErrorCode::ErrorCode_Success );
 }
 
@@ -1,28 +1,116 @@
 #pragma once
 
+#include <exception>
+#include <deque>
 #include "gcdmodel.h"
+#include "gcdexcl.h"
 
 namespace pictcli_gcd
 {
 
+//
+// formats the rows the engine hands out and writes them out right away
+// nothing is written before the first row so the errors found before the engine builds any
+// leave the output empty; the seed and the warnings go out just ahead of the header
+//
+class CRowStreamer : public RowSink
+{
+public:
+    CRowStreamer( CModelData& modelData, CResult& result, std::wostream& wout ) :
+        _modelData( modelData ), _result( result ), _writer( modelData, wout ), _begun( false ) {}
+
+    void WriteRow( const std::vector<size_t>& values ) override;
+
+    // once the generation succeeded, a suite with no rows still gets its header
+    void End();
+
+private:
+    CModelData&   _modelData;
+    CResult&      _result;
+    CResultWriter _writer;
+    bool          _begun;
+
+    void begin();
+};
+
+//
+// one pass of the engine over a variant of the model; the negative one only contributes
+// rows with invalid values
+//
+class CGcdRun
+{
+public:
+    CGcdRun( CModelData& modelData, bool justNegative ) :
+        ModelData( modelData ), GcdData( modelData ), JustNegative( justNegative ),
+        Error( ErrorCode::ErrorCode_Success ) {}
+
+    CModelData&        ModelData;
+    CGcdData           GcdData;
+    bool               JustNegative;
+
+    // outcome of the engine's work, exceptions are kept until they can be reported in order
+    ErrorCode          Error;
+    std::exception_ptr Failure;
+};
+
+//
+// a candidate of a portfolio: a run of each variant of the model, all with the candidate's seed
+//
+class CGcdCandidate
+{
+public:
+    CGcdCandidate( unsigned int index ) : Index( index ), Rows( 0 ), Failed( false ) {}
+
+    unsigned int                              Index;
+    std::deque< CModelData >                  Models;   // a deque doesn't move them around
+    std::vector< std::unique_ptr< CGcdRun >> Runs;
+    size_t                                    Rows;
+    bool                                      Failed;
+};
+
+//
+//
+//
 class GcdRunner
 {
 public:
-    GcdRunner( CModelData& modelData ) : _modelData( modelData ) {}
+    // given an output, rows of models that allow it are written there as they are generated
+    GcdRunner( CModelData& modelData, std::wostream* output = nullptr ) :
+        _modelData( modelData ), _output( output ), _streamed( false ) {}
 
     ErrorCode Generate();
 
     CResult GetResult() { return( _result ); }
 
+    // the rows have already been written out, the result holds none of them
+    bool IsStreamed() { return( _streamed ); }
+
 private:
-    CModelData& _modelData;
-    CResult     _result;
+    CModelData&    _modelData;
+    CResult        _result;
+    std::wostream* _output;
+    bool           _streamed;
+
+    ErrorCode generateResults( IN CGcdRun& run,
+                               IN ConstraintsInterpreter& constraints,
+                               IN bool allowStreaming );
+
+    ErrorCode translateModel  ( IN CGcdRun& run, IN ConstraintsInterpreter& constraints );
+    ErrorCode checkExclusions ( IN CGcdRun& run );
+    ErrorCode collectResults  ( IN CGcdRun& run );
+
+    void deriveExclusions( IN CGcdRun& run );
+    void runEngine       ( IN CGcdRun& run );
+
+    std::unique_ptr< CGcdCandidate > runCandidate( IN unsigned int index,
+                                                   IN std::vector< std::unique_ptr< CGcdRun >>& variants,
+                                                   IN unsigned int threadCount,
+                                                   IN unsigned int variantThreads );
+
+    ErrorCode generateSideBySide( IN CModelData& negativeModelData, IN ConstraintsInterpreter& constraints );
 
-    ErrorCode generateResults( IN CModelData& modelData,
-                               IN bool justNegative );
-    
     void translateResults( IN CModelData& modelData,
-                           IN ResultCollection& resultCollection,
+                           IN ResultTable& results,
                            IN bool justNegative );
 };
 
@@ -43,25 +43,17 @@ bool ConstraintsInterpreter::isNumericRelationSatisfied( IN double       value,
 }
 
 //
+// Both keys come from value dictionaries so they are already upper-cased if need be
 //
-//
-bool ConstraintsInterpreter::isStringRelationSatisfied( IN wstring&     value,
-                                                        IN RelationType relationType,
-                                                        IN wstring&     valueToCompareWith )
+bool ConstraintsInterpreter::isStringRelationSatisfied( IN const wchar_t* key,
+                                                        IN RelationType   relationType,
+                                                        IN const wchar_t* keyToCompareWith )
 {
     // take care of LIKEs
     if ( RelationType::Like    == relationType
       || RelationType::NotLike == relationType )
     {
-        wstring text    = value;
-        wstring pattern = valueToCompareWith;
-        if ( ! _modelData.CaseSensitive )
-        {
-            toUpper( text );
-            toUpper( pattern );
-        }
-
-        bool ret = patternMatch( pattern, text );
+        bool ret = patternMatch( keyToCompareWith, key );
         if ( RelationType::NotLike == relationType )
         {
             ret = ! ret;
@@ -71,30 +63,32 @@ bool ConstraintsInterpreter::isStringRelationSatisfied( IN wstring&     value,
     // and all other relations except INs
     else
     {
-        double diff = (double) stringCompare( value, valueToCompareWith, _modelData.CaseSensitive );
+        double diff = (double) wcscmp( key, keyToCompareWith );
         return( isRelationSatisfied( diff, relationType ));
     }
 }
 
 //
+// Any name of the value may satisfy the relation; numeric parameters are compared by number,
+//  others by key
 //
-//
-bool ConstraintsInterpreter::valueSatisfiesRelation( IN CParameter&  parameter,
-                                                     IN CModelValue& value,
-                                                     IN RelationType relationType,
-                                                     IN CValue*      data )
+bool ConstraintsInterpreter::valueSatisfiesRelation( IN const CValueDictionary& dictionary,
+                                                     IN unsigned int            valueIdx,
+                                                     IN DataType                dataType,
+                                                     IN RelationType            relationType,
+                                                     IN double                  number,
+                                                     IN const wchar_t*          key )
 {
-    wstrings names = value.GetNamesForComparisons();
-    for( auto & name : names )
+    for( unsigned int nameIdx = dictionary.NameBegin( valueIdx ); nameIdx < dictionary.NameEnd( valueIdx ); ++nameIdx )
     {
         bool relSatisfied = false;
-        if ( parameter.Type == DataType::Number )
+        if ( dataType == DataType::Number )
         {
-            relSatisfied = isNumericRelationSatisfied( stringToNumber( name ), relationType, data->Number );
+            relSatisfied = isNumericRelationSatisfied( dictionary.GetNumber( nameIdx ), relationType, number );
         }
-        else if ( parameter.Type == DataType::String )
+        else if ( dataType == DataType::String )
         {
-            relSatisfied = isStringRelationSatisfied( name, relationType, data->Text );
+            relSatisfied = isStringRelationSatisfied( dictionary.GetKey( nameIdx ), relationType, key );
         }
         else
         {
@@ -109,19 +103,23 @@ bool ConstraintsInterpreter::valueSatisfiesRelation( IN CParameter&  parameter,
 //
 //
 //
-void ConstraintsInterpreter::interpretTerm( IN CTerm* term, OUT CGcdExclusions& gcdExclusions )
+ConstraintsInterpreter::Family ConstraintsInterpreter::interpretTerm( IN CTerm* term )
 {
+    Family family = ExclusionFamilies::Empty;
+
     // a useful simplification: gcdData.Parameters, constrModel.Parameters, and modelData.Parameters
     // have elements in the same order thus indexes correspond to the same parameters
 
     // find the param in modelData
-    vector< CModelParameter >::iterator found = _modelData.FindParameterByName( term->Parameter->Name );
-    assert( found != _modelData.Parameters.end() );
+    vector< CModelParameter >::iterator found = _modelData->FindParameterByName( term->Parameter->Name );
+    assert( found != _modelData->Parameters.end() );
     CModelParameter& modelParam = *found;
+    const CValueDictionary& dictionary = modelParam.Dictionary;
+    assert( dictionary.GetValueCount() == modelParam.Values.size() );
 
     // find the parameter in gcdParam
-    unsigned int paramIdx = (unsigned int) distance( _modelData.Parameters.begin(), found );
-    CParameter parameter = _constrModel.Parameters[ paramIdx ];
+    unsigned int paramIdx = (unsigned int) distance( _modelData->Parameters.begin(), found );
+    CParameter& parameter = _constrModel.Parameters[ paramIdx ];
 
     // set up the structure: a vector of as many elements as there are values, initially set all
     //  to false; then for every value that satisfies the relation set corresponding element to true
@@ -134,10 +132,12 @@ void ConstraintsInterpreter::interpretTerm( IN CTerm* term, OUT CGcdExclusions&
     // everything except INs
     case TermDataType::Value:
         {
-            for( size_t valueIdx = 0; valueIdx < modelParam.Values.size(); ++valueIdx )
+            CValue* data = (CValue*) term->Data;
+            wstring key = dictionary.MakeKey( data->Text );
+
+            for( unsigned int valueIdx = 0; valueIdx < modelParam.Values.size(); ++valueIdx )
             {
-                CModelValue& value = modelParam.Values[ valueIdx ];
-                if( valueSatisfiesRelation( parameter, value, term->RelationType, (CValue*) term->Data ) )
+                if( valueSatisfiesRelation( dictionary, valueIdx, parameter.Type, term->RelationType, data->Number, key.c_str() ))
                 {
                     satisfyingValues[ valueIdx ] = true;
                 }
@@ -150,16 +150,22 @@ void ConstraintsInterpreter::interpretTerm( IN CTerm* term, OUT CGcdExclusions&
             assert( term->RelationType == RelationType::In 
                  || term->RelationType == RelationType::NotIn );
 
-            for( size_t valueIdx = 0; valueIdx < modelParam.Values.size(); ++valueIdx )
+            CValueSet* valueSet = (CValueSet*) term->Data;
+            vector< double > numbers;
+            wstrings         keys;
+            for( auto & vset : *valueSet )
+            {
+                numbers.push_back( vset.Number );
+                keys.push_back( dictionary.MakeKey( vset.Text ));
+            }
+
+            for( unsigned int valueIdx = 0; valueIdx < modelParam.Values.size(); ++valueIdx )
             {
-                CModelValue& value = modelParam.Values[ valueIdx ];
-            
                 // any name must satisfy any value
                 bool satisfied = false;
-                CValueSet* valueSet = (CValueSet*) term->Data;
-                for( auto & vset : *valueSet )
+                for( size_t idx = 0; idx < keys.size(); ++idx )
                 {
-                    if ( valueSatisfiesRelation( parameter, value, RelationType::Eq, &vset ))
+                    if ( valueSatisfiesRelation( dictionary, valueIdx, parameter.Type, RelationType::Eq, numbers[ idx ], keys[ idx ].c_str() ))
                     {
                         satisfied = true;
                         break;
@@ -177,53 +183,39 @@ void ConstraintsInterpreter::interpretTerm( IN CTerm* term, OUT CGcdExclusions&
 
     case TermDataType::ParameterName:
         {
-            // find the param in modelData
-            vector< CModelParameter >::iterator found1 = _modelData.FindParameterByName( term->Parameter->Name );
-            assert( found1 != _modelData.Parameters.end() );
-            CModelParameter& modelParam1 = *found1;
-            unsigned int param1Idx = (unsigned int) distance( _modelData.Parameters.begin(), found1 );
-            CParameter parameter1 = _constrModel.Parameters[ param1Idx ];
-
-            vector< CModelParameter >::iterator found2 = _modelData.FindParameterByName( ((CParameter*) term->Data)->Name );
-            assert( found2 != _modelData.Parameters.end() );
+            vector< CModelParameter >::iterator found2 = _modelData->FindParameterByName( ((CParameter*) term->Data)->Name );
+            assert( found2 != _modelData->Parameters.end() );
             CModelParameter& modelParam2 = *found2;
-            unsigned int param2Idx = (unsigned int) distance( _modelData.Parameters.begin(), found2 );
-            CParameter parameter2 = _constrModel.Parameters[ param2Idx ];
+            const CValueDictionary& dictionary2 = modelParam2.Dictionary;
+            assert( dictionary2.GetValueCount() == modelParam2.Values.size() );
+            unsigned int param2Idx = (unsigned int) distance( _modelData->Parameters.begin(), found2 );
 
-            for( unsigned int value1Idx = 0; value1Idx < modelParam1.Values.size(); ++value1Idx )
+            vector< bool > satisfyingPairs( modelParam.Values.size() * modelParam2.Values.size(), false );
+
+            // the values of the second parameter that satisfy the relation with a value of the first
+            //  are gathered first, from the last one, and then put together with that value
+            for( unsigned int value1Idx = static_cast< unsigned int >( modelParam.Values.size() ); value1Idx-- > 0; )
             {
-                CModelValue value1 = modelParam1.Values[ value1Idx ];
-                // if any name of value1 satifies the relation with any of the names of value2, values match
-                for( unsigned int value2Idx = 0; value2Idx < modelParam2.Values.size(); ++value2Idx )
-                {
-                    CModelValue value2 = modelParam2.Values[ value2Idx ];
+                Family partners = ExclusionFamilies::Empty;
 
-                    for( auto & name2 : value2.GetNamesForComparisons() )
+                // if any name of value1 satifies the relation with any of the names of value2, values match;
+                //  the parser made sure both parameters are of the same type
+                for( unsigned int value2Idx = static_cast< unsigned int >( modelParam2.Values.size() ); value2Idx-- > 0; )
+                {
+                    for( unsigned int name2Idx = dictionary2.NameBegin( value2Idx ); name2Idx < dictionary2.NameEnd( value2Idx ); ++name2Idx )
                     {
-                        // create temp CValue to use compare function
-                        CValue* v2;
-                        if ( DataType::Number == parameter2.Type )
+                        if( valueSatisfiesRelation( dictionary, value1Idx, parameter.Type, term->RelationType,
+                                                    dictionary2.GetNumber( name2Idx ), dictionary2.GetKey( name2Idx )))
                         {
-                            v2 = new CValue( stringToNumber( name2 ));
+                            partners = _families->Union( partners, _families->Single( param2Idx, value2Idx ));
+                            satisfyingPairs[ value1Idx * modelParam2.Values.size() + value2Idx ] = true;
+                            break;
                         }
-                        else
-                        {
-                            v2 = new CValue( name2 );
-                        }
-
-                        if( valueSatisfiesRelation( parameter1, value1, term->RelationType, v2 ))
-                        {
-                            Exclusion newExcl;
-
-                            newExcl.insert( make_pair( _gcdParameters[ param1Idx ], value1Idx ));
-                            newExcl.insert( make_pair( _gcdParameters[ param2Idx ], value2Idx ));
-
-                            gcdExclusions.insert( newExcl );
-                        }
-                        delete( v2 );
                     }
                 }
+                family = _families->Union( family, _families->Product( _families->Single( paramIdx, value1Idx ), partners ));
             }
+            _predicate->AddPairTest( paramIdx, param2Idx, static_cast< unsigned int >( modelParam2.Values.size() ), satisfyingPairs );
         }
     }
 
@@ -253,24 +245,28 @@ void ConstraintsInterpreter::interpretTerm( IN CTerm* term, OUT CGcdExclusions&
             _warnings.push_back( s );
         }
 
-        // create exclusions
-        for( unsigned int idx = 0; idx < satisfyingValues.size(); ++idx )
+        // create exclusions; going from the last value each one goes on top of the family
+        //  instead of being merged in under all the others
+        for( unsigned int idx = static_cast< unsigned int >( satisfyingValues.size() ); idx-- > 0; )
         {
             if( satisfyingValues[ idx ] )
             {
-                Exclusion newExcl;
-                newExcl.insert( make_pair( _gcdParameters[ paramIdx ], idx ));
-                gcdExclusions.insert( newExcl );
+                family = _families->Union( family, _families->Single( paramIdx, idx ));
             }
         }
+        _predicate->AddValueTest( paramIdx, satisfyingValues );
     }
+
+    return( family );
 }
 
 //
 //
 //
-void ConstraintsInterpreter::interpretFunction( IN CFunction* function, IN OUT CGcdExclusions &gcdExclusions )
+ConstraintsInterpreter::Family ConstraintsInterpreter::interpretFunction( IN CFunction* function )
 {
+    Family family = ExclusionFamilies::Empty;
+
     switch( function->Type )
     {
     case FunctionType::IsNegativeParam:
@@ -278,24 +274,25 @@ void ConstraintsInterpreter::interpretFunction( IN CFunction* function, IN OUT C
         {
             // a useful simplification: gcdData.Parameters, constrModel.Parameters, and modelData.Parameters
             // have elements in the same order thus indexes correspond to the same parameters
-            vector< CModelParameter >::iterator found = _modelData.FindParameterByName( ( static_cast<CParameter*> ( function->Data ))->Name );
+            vector< CModelParameter >::iterator found = _modelData->FindParameterByName( ( static_cast<CParameter*> ( function->Data ))->Name );
             CModelParameter& modelParam = *found;
 
             // find the parameter in gcdParam
-            unsigned int paramIdx = (unsigned int) distance( _modelData.Parameters.begin(), found );
+            unsigned int paramIdx = (unsigned int) distance( _modelData->Parameters.begin(), found );
 
             // add values to the result
+            vector< bool > satisfyingValues( modelParam.Values.size(), false );
             for( unsigned int idx = 0; idx < modelParam.Values.size(); ++idx )
             {
                 bool positive = modelParam.Values[ idx ].IsPositive();
                 if( (function->Type == FunctionType::IsNegativeParam && ! positive)
                  || (function->Type == FunctionType::IsPositiveParam &&   positive) )
                 {
-                    Exclusion newExcl;
-                    newExcl.insert( make_pair( _gcdParameters[ paramIdx ], idx ));
-                    gcdExclusions.insert( newExcl );
+                    family = _families->Union( family, _families->Single( paramIdx, idx ));
+                    satisfyingValues[ idx ] = true;
                 }
             }
+            _predicate->AddValueTest( paramIdx, satisfyingValues );
             break;
         }
     default:
@@ -304,128 +301,85 @@ void ConstraintsInterpreter::interpretFunction( IN CFunction* function, IN OUT C
             break;
         }
     }
+
+    return( family );
 }
 
 //
 //
 //
-void ConstraintsInterpreter::interpretSyntaxTreeItem( IN CSyntaxTreeItem* item, IN OUT CGcdExclusions& gcdExclusions )
+ConstraintsInterpreter::Family ConstraintsInterpreter::interpretSyntaxTreeItem( IN CSyntaxTreeItem* item )
 {
-    if ( nullptr == item ) return;
+    if ( nullptr == item )
+    {
+        // an OR of nothing is never true
+        _predicate->OpenAny();
+        _predicate->Close();
+        return( ExclusionFamilies::Empty );
+    }
 
     // a case where where there is no condition
     if ( SyntaxTreeItemType::Term == item->Type )
     {
-        interpretTerm( (CTerm*)item->Data, gcdExclusions );
+        return( interpretTerm( (CTerm*)item->Data ));
     }
     // a function call to intepret
     else if ( SyntaxTreeItemType::Function == item->Type )
     {
-        interpretFunction( (CFunction*)item->Data, gcdExclusions );
+        return( interpretFunction( (CFunction*)item->Data ));
     }
     // otherwise it is a cross-product or a union
     else if ( SyntaxTreeItemType::Node == item->Type )
     {
         CSyntaxTreeNode* node = (CSyntaxTreeNode*) item->Data;
-
-        CGcdExclusions leftExclusions;
-        interpretSyntaxTreeItem( node->LLink, leftExclusions );
-        CGcdExclusions rightExclusions;
-        interpretSyntaxTreeItem( node->RLink, rightExclusions );
+        assert( LogicalOper::And == node->Oper || LogicalOper::Or == node->Oper );
 
         if ( LogicalOper::And == node->Oper )
         {
-            for( auto & left : leftExclusions )
-            {
-                for( auto & right : rightExclusions )
-                {
-                    Exclusion newExcl;
-                    __insert( newExcl, left.begin(),  left.end() );
-                    __insert( newExcl, right.begin(), right.end() );
-                    gcdExclusions.insert( newExcl );
-                }
-            }
+            _predicate->OpenAll();
         }
-        else if ( LogicalOper::Or == node->Oper )
+        else
+        {
+            _predicate->OpenAny();
+        }
+        Family leftExclusions  = interpretSyntaxTreeItem( node->LLink );
+        Family rightExclusions = interpretSyntaxTreeItem( node->RLink );
+        _predicate->Close();
+
+        if ( LogicalOper::And == node->Oper )
         {
-            __insert( gcdExclusions, leftExclusions.begin(),  leftExclusions.end() );
-            __insert( gcdExclusions, rightExclusions.begin(), rightExclusions.end() );
+            return( _families->Product( leftExclusions, rightExclusions ));
         }
         else
         {
-            assert( false );
+            return( _families->Union( leftExclusions, rightExclusions ));
         }
     }
     else
     {
         assert( false );
     }
+    return( ExclusionFamilies::Empty );
 }
 
 //
 //
 //
-void ConstraintsInterpreter::interpretConstraint( IN const CConstraint& constraint, IN OUT CGcdExclusions& gcdExclusions )
+ConstraintsInterpreter::Family ConstraintsInterpreter::interpretConstraint( IN const CConstraint& constraint )
 {
     // if there's no condition, look at the term only
     if ( nullptr == constraint.Condition )
     {
-        interpretSyntaxTreeItem( constraint.Term, gcdExclusions );
+        return( interpretSyntaxTreeItem( constraint.Term ));
     }
     // cross-product for the condition and term otherwise
     else
     {
-        CGcdExclusions condExclusions;
-        interpretSyntaxTreeItem( constraint.Condition, condExclusions );
-    
-        CGcdExclusions termExclusions;
-        interpretSyntaxTreeItem( constraint.Term, termExclusions);
-
-        for( auto & cond : condExclusions )
-        {
-            for( auto & term : termExclusions )
-            {
-                Exclusion newExcl;
-
-                __insert( newExcl, cond.begin(), cond.end() );
-                __insert( newExcl, term.begin(), term.end() );
-
-                gcdExclusions.insert( newExcl );
-            }
-        }
-    } 
-}
-
-//
-// contradicting exclusion refer to the same parameter but have different values
-// e.g.: A:1, A:2, B:1
-//
-void ConstraintsInterpreter::removeContradictingExclusions( IN OUT CGcdExclusions& gcdExclusions )
-{
-    CGcdExclusions::iterator i_excl = gcdExclusions.begin();
-    while ( i_excl != gcdExclusions.end() )
-    {
-        bool obsolete = false;
-        for ( Exclusion::iterator i_ecurr =  i_excl->begin();
-                                  i_ecurr != i_excl->end();
-                                  i_ecurr++ )
-        {
-            Exclusion::iterator i_enext = i_ecurr;
-            if ( ++i_enext == i_excl->end() ) break;
-            if ( i_ecurr->first == i_enext->first ) 
-            {
-                obsolete = true;
-                break;
-            }
-        }
-        if ( obsolete )
-        {
-            i_excl = __map_erase( gcdExclusions, i_excl );
-        }
-        else
-        {
-            i_excl++;
-        }
+        _predicate->OpenAll();
+        Family condExclusions = interpretSyntaxTreeItem( constraint.Condition );
+        Family termExclusions = interpretSyntaxTreeItem( constraint.Term );
+        _predicate->Close();
+        return( _families->Product( condExclusions, termExclusions ));
     }
 }
 
@@ -434,20 +388,7 @@ void ConstraintsInterpreter::removeContradictingExclusions( IN OUT CGcdExclusion
 //
 DataType ConstraintsInterpreter::getParameterDataType( CModelParameter& parameter )
 {
-    // assume numeric until proven otherwise
-    DataType parameterType = DataType::Number;
-    for( auto & value : parameter.Values )
-    {
-        for( auto & name : value.GetNamesForComparisons() )
-        {
-            if( !textContainsNumber( name ) )
-            {
-                parameterType = DataType::String;
-                break;
-            }
-        }
-    }
-    return( parameterType );
+    return( parameter.Dictionary.AllNumbers() ? DataType::Number : DataType::String );
 }
 
 //
@@ -483,10 +424,56 @@ wstring ConstraintsInterpreter::getConstraintTextForContext( wstring& constraint
 //
 //
 //
-bool ConstraintsInterpreter::ConvertToExclusions( OUT CGcdExclusions& gcdExclusions )
+ConstraintsInterpreter::ConstraintsInterpreter() :
+    _modelData( nullptr ), _families( nullptr ), _predicate( nullptr ), _parsed( false ), _parseFailed( false )
+{
+}
+
+//
+//
+//
+ConstraintsInterpreter::~ConstraintsInterpreter()
+{
+    // syntax trees point to tokens so the parser must go first
+    _parser.reset();
+    _tokenizer.reset();
+}
+
+//
+// The syntax trees only depend on parameter names and types, values are looked up
+// in whatever model the constraints are being interpreted for
+//
+bool ConstraintsInterpreter::CanConvert( IN CModelData& modelData )
 {
+    if( !_parsed ) return( true );
+
+    if( modelData.Parameters.size() != _constrModel.Parameters.size() ) return( false );
+    for( size_t index = 0; index < modelData.Parameters.size(); ++index )
+    {
+        CModelParameter& param = modelData.Parameters[ index ];
+        if( param.Name != _constrModel.Parameters[ index ].Name
+         || param.IsResultParameter != _constrModel.Parameters[ index ].ResultParam
+         || getParameterDataType( param ) != _constrModel.Parameters[ index ].Type )
+        {
+            return( false );
+        }
+    }
+    return( true );
+}
+
+//
+//
+//
+bool ConstraintsInterpreter::parse()
+{
+    if( _parsed ) return( !_parseFailed );
+    _parsed      = true;
+    _parseFailed = true;
+
+    _constrModel.CaseSensitive = _modelData->CaseSensitive;
+
     // translate parameters to a form understandable by the core engine
-    for( auto & param : _modelData.Parameters )
+    for( auto & param : _modelData->Parameters )
     {
         CParameter parameter;
         parameter.Name        = param.Name;
@@ -500,14 +487,14 @@ bool ConstraintsInterpreter::ConvertToExclusions( OUT CGcdExclusions& gcdExclusi
     // 1. tokenize the constraints
     try
     {
-        ConstraintsTokenizer tokenizer( _constrModel, _modelData.ConstraintPredicates );
+        _tokenizer.reset( new ConstraintsTokenizer( _constrModel, _modelData->ConstraintPredicates ));
         try
         {
-            tokenizer.Tokenize();
+            _tokenizer->Tokenize();
         }
         catch( CSyntaxError e )
         {
-            wstring text = getConstraintTextForContext( _modelData.ConstraintPredicates, e.ErrAtPosition );
+            wstring text = getConstraintTextForContext( _modelData->ConstraintPredicates, e.ErrAtPosition );
             const wchar_t* failureContext = text.c_str();
 
             // print message
@@ -564,19 +551,19 @@ bool ConstraintsInterpreter::ConvertToExclusions( OUT CGcdExclusions& gcdExclusi
         }
 
         // 2. parse the constraints
-        ConstraintsParser parser( tokenizer.GetTokenLists() );
+        _parser.reset( new ConstraintsParser( _tokenizer->GetTokenLists() ));
 
         try
         {
-            parser.GenerateSyntaxTrees();
+            _parser->GenerateSyntaxTrees();
 
-            for( auto & warning : parser.GetWarnings() )
+            for( auto & warning : _parser->GetWarnings() )
             {
                 switch( warning.Type )
                 {
                 case ValidationWarnType::UnknownParameter:
                     {
-                    wstring constraintText = _modelData.GetConstraintText( warning.ErrInConstraint );
+                    wstring constraintText = _modelData->GetConstraintText( warning.ErrInConstraint );
                     const wchar_t* failureContext = constraintText.c_str();
                     PrintMessage( ConstraintsWarning, L"Constraint", failureContext, L"contains unknown parameter. Skipping..." );
                     break;
@@ -591,7 +578,7 @@ bool ConstraintsInterpreter::ConvertToExclusions( OUT CGcdExclusions& gcdExclusi
         }
         catch( CErrValidation e )
         {
-            wstring constraintText = _modelData.GetConstraintText( e.ErrInConstraint );
+            wstring constraintText = _modelData->GetConstraintText( e.ErrInConstraint );
             const wchar_t* failureContext = constraintText.c_str();
             
             switch( e.Type )
@@ -622,25 +609,56 @@ bool ConstraintsInterpreter::ConvertToExclusions( OUT CGcdExclusions& gcdExclusi
             return( false );
         }
 
-        // 3. interpret and translate into a form understanable by the core engine
-        const CConstraints& constraints = parser.GetConstraints();
+        _constraints = _parser->GetConstraints();
 
-        if ( _modelData.Verbose )
+        if ( _modelData->Verbose )
         {
             PrintLogHeader( L"Constraints: Output from syntax parsing" );
-            for( auto & c : constraints )
+            for( auto & c : _constraints )
             {
                 c.Print();
             }
         }
+    }
+    catch( const std::bad_alloc& )
+    { 
+        throw new GenerationError( __FILE__, __LINE__, ErrorType::OutOfMemory );
+    }
+
+    _parseFailed = false;
+    return( true );
+}
+
+//
+//
+//
+bool ConstraintsInterpreter::ConvertToExclusions( IN CModelData& modelData, IN vector< Parameter* >& gcdParameters,
+                                                  OUT CGcdExclusions& gcdExclusions, OUT CConstraintPredicate& predicate )
+{
+    assert( CanConvert( modelData ));
+
+    _modelData     = &modelData;
+    _warnings.clear();
+
+    if( !parse() ) return( false );
+
+    // 3. interpret and translate into a form understanable by the core engine; the families
+    //  never hold contradicting exclusions, ones with two values of the same parameter
+    try
+    {
+        ExclusionFamilies families( gcdParameters );
+        _families  = &families;
+        _predicate = &predicate;
 
-        for( auto & c : constraints )
+        Family all = ExclusionFamilies::Empty;
+        for( auto & c : _constraints )
         {
-            interpretConstraint( c, gcdExclusions );
+            all = families.Union( all, interpretConstraint( c ));
         }
+        families.Extract( all, gcdExclusions );
 
-        // last-minute cleanup
-        removeContradictingExclusions( gcdExclusions );
+        _families  = nullptr;
+        _predicate = nullptr;
     }
     catch( const std::bad_alloc& )
     { 
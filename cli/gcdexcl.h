@@ -1,47 +1,67 @@
 #pragma once
 
+#include <memory>
 #include "ccommon.h"
 #include "gcdmodel.h"
+#include "gcdzdd.h"
 namespace pcc = pictcli_constraints;
 
+namespace pictcli_constraints
+{
+class ConstraintsTokenizer;
+class ConstraintsParser;
+}
+
 namespace pictcli_gcd
 {
 
 class ConstraintsInterpreter
 {
 public:
-    ConstraintsInterpreter( IN CModelData& modelData, IN std::vector< Parameter* >& gcdParameters )
-        : _modelData( modelData ), _gcdParameters ( gcdParameters )
-    {
-        _constrModel.CaseSensitive = _modelData.CaseSensitive;
-    }
+    ConstraintsInterpreter();
+    ~ConstraintsInterpreter();
 
-    bool ConvertToExclusions( CGcdExclusions& gcdExclusions );
+    // the constraints are parsed on the first conversion, later models reuse the syntax trees;
+    // the predicate gets the constraints compiled for checking rows directly
+    bool ConvertToExclusions( IN CModelData& modelData, IN std::vector< Parameter* >& gcdParameters,
+                              OUT CGcdExclusions& gcdExclusions, OUT CConstraintPredicate& predicate );
+
+    // syntax trees can be shared by models whose parameters have the same names and types
+    bool CanConvert( IN CModelData& modelData );
 
     const wstrings& GetWarnings() { return( _warnings ); }
 
 private:
-    void interpretConstraint    ( IN const pcc::CConstraint& constraint, IN OUT CGcdExclusions& gcdExclusions );
-    void interpretSyntaxTreeItem( IN pcc::CSyntaxTreeItem* item,         IN OUT CGcdExclusions& gcdExclusions );
-    void interpretTerm          ( IN pcc::CTerm* term,                   IN OUT CGcdExclusions& gcdExclusions );
-    void interpretFunction      ( IN pcc::CFunction* function,           IN OUT CGcdExclusions& gcdExclusions );
+    typedef ExclusionFamilies::Family Family;
+
+    Family interpretConstraint    ( IN const pcc::CConstraint& constraint );
+    Family interpretSyntaxTreeItem( IN pcc::CSyntaxTreeItem* item );
+    Family interpretTerm          ( IN pcc::CTerm* term );
+    Family interpretFunction      ( IN pcc::CFunction* function );
 
-    void removeContradictingExclusions( IN OUT CGcdExclusions& gcdExclusions );
+    bool parse();
 
     bool isRelationSatisfied       ( IN double diff,         IN pcc::RelationType relationType );
     bool isNumericRelationSatisfied( IN double value,        IN pcc::RelationType relationType, IN double valueToCompareWith );
-    bool isStringRelationSatisfied ( IN std::wstring& value, IN pcc::RelationType relationType, IN std::wstring& valueToCompareWith );
+    bool isStringRelationSatisfied ( IN const wchar_t* key,  IN pcc::RelationType relationType, IN const wchar_t* keyToCompareWith );
 
-    bool valueSatisfiesRelation    ( IN pcc::CParameter& parameter, IN CModelValue& value,
-                                     IN pcc::RelationType relationType, IN pcc::CValue* data );
+    bool valueSatisfiesRelation    ( IN const CValueDictionary& dictionary, IN unsigned int valueIdx, IN pcc::DataType dataType,
+                                     IN pcc::RelationType relationType, IN double number, IN const wchar_t* key );
 
     pcc::DataType getParameterDataType( CModelParameter& parameter );
     std::wstring getConstraintTextForContext( std::wstring& constraintsText, std::wstring::iterator position );
 
-    CModelData&                _modelData;
-    std::vector< Parameter* >& _gcdParameters;
+    CModelData*                _modelData;
+    ExclusionFamilies*         _families;
+    CConstraintPredicate*      _predicate;
     pcc::CModel                _constrModel;
     wstrings                   _warnings;
+
+    std::unique_ptr< pcc::ConstraintsTokenizer > _tokenizer;
+    std::unique_ptr< pcc::ConstraintsParser >    _parser;
+    pcc::CConstraints                            _constraints;
+    bool                                         _parsed;
+    bool                                         _parseFailed;
 };
 
 }
@@ -76,6 +76,15 @@ wstrings CGcdData::GetSingleItemExclusions()
 //
 //
 bool CGcdData::FixParamOrder( IN Model* submodel )
+{
+    return( FixParamOrder( vector< Model* >( 1, submodel )));
+}
+
+//
+// Submodels generated at the same time share no parameters so each can have its
+// order assigned as if it was the only one
+//
+bool CGcdData::FixParamOrder( IN const vector< Model* >& submodels )
 {
     // clean order assignments for non-result params, set order of result params to 1
     for( auto & param : _modelData.Parameters )
@@ -90,39 +99,42 @@ bool CGcdData::FixParamOrder( IN Model* submodel )
         }
     }
 
-    // If this is an actual submodel (a model other than the root), by now it will have its
-    // order defined so use it across all its parameters
-    if( submodel != _task.GetRootModel() )
+    for( auto & submodel : submodels )
     {
-        for( auto & param : submodel->GetParameters() )
+        // If this is an actual submodel (a model other than the root), by now it will have its
+        // order defined so use it across all its parameters
+        if( submodel != _task.GetRootModel() )
         {
-            if( UNDEFINED_ORDER == param->GetOrder() )
+            for( auto & param : submodel->GetParameters() )
             {
-                param->SetOrder( submodel->GetOrder() );
+                if( UNDEFINED_ORDER == param->GetOrder() )
+                {
+                    param->SetOrder( submodel->GetOrder() );
+                }
             }
         }
-    }
 
-    // For the root model, use orders specified in parameter definitions or if none was
-    // defined, use the default order of the model
-    else
-    {
-        // order from param definitions
-        for( auto & param : submodel->GetParameters() )
+        // For the root model, use orders specified in parameter definitions or if none was
+        // defined, use the default order of the model
+        else
         {
-            if( UNDEFINED_ORDER == param->GetOrder() )
+            // order from param definitions
+            for( auto & param : submodel->GetParameters() )
             {
-                auto p = _modelData.FindParameterByGcdPointer( param );
-                assert( p != _modelData.Parameters.end() );
-                if( p->Order != static_cast<unsigned int>(UNDEFINED_ORDER) )
-                {
-                    // TODO: add verification of Order
-                    // if p->Order > model->parameters.count - model.ResultParameters.count then error out
-                    param->SetOrder( p->Order );
-                }
-                else
+                if( UNDEFINED_ORDER == param->GetOrder() )
                 {
-                    param->SetOrder( submodel->GetOrder() );
+                    auto p = _modelData.FindParameterByGcdPointer( param );
+                    assert( p != _modelData.Parameters.end() );
+                    if( p->Order != static_cast<unsigned int>(UNDEFINED_ORDER) )
+                    {
+                        // TODO: add verification of Order
+                        // if p->Order > model->parameters.count - model.ResultParameters.count then error out
+                        param->SetOrder( p->Order );
+                    }
+                    else
+                    {
+                        param->SetOrder( submodel->GetOrder() );
+                    }
                 }
             }
         }
@@ -137,15 +149,19 @@ bool CGcdData::FixParamOrder( IN Model* submodel )
 typedef map< CModelParameter*, Parameter* > CParamMap;
 
 //
-// the main proc translating the model gathered from the UI to one used by the engine
+// builds the engine's models and parameters, everything but the exclusions
 //
-ErrorCode CGcdData::TranslateToGCD()
+bool CGcdData::translateModel()
 {
     Model* rootModel = new Model( L"", GenerationType::MixedOrder, _modelData.Order, _modelData.RandSeed );
     Models.push_back( rootModel );
 
     _task.SetRootModel( rootModel );
     _task.SetGenerationMode( _modelData.GenerationMode );
+    _task.SetThreadCount( static_cast<int>( _modelData.ThreadCount ) );
+    _task.SetCandidateCount( static_cast<int>( _modelData.CandidateCount ) );
+    _task.SetCompactResults( _modelData.CompactResults );
+    _task.SetLazyConstraints( _modelData.LazyConstraints );
     if( _modelData.GenerationMode == GenerationMode::Approximate )
     {
         _task.SetMaxRandomTries( _modelData.MaxApproxTries );
@@ -265,23 +281,32 @@ ErrorCode CGcdData::TranslateToGCD()
     }
 
     // make sure all order fields in models are set appropriately
-    if( !fixModelAndSubmodelOrder() )
+    return( fixModelAndSubmodelOrder() );
+}
+
+//
+// the main proc translating the model gathered from the UI to one used by the engine
+// constraints already parsed for another variant of the model are only interpreted again
+//
+ErrorCode CGcdData::TranslateToGCD( IN ConstraintsInterpreter& constraints )
+{
+    if( !translateModel() )
     {
         return( ErrorCode::ErrorCode_BadModel );
     }
-    
+
     // add exclusions for negative values
     addExclusionsForNegativeRun();
 
     // add user-specified exclusions now
     
     // parse the constraints and make exclusions out of them
-    ConstraintsInterpreter interpreter( _modelData, Parameters );
-    if( !interpreter.ConvertToExclusions( Exclusions ) )
+    if( !constraints.ConvertToExclusions( _modelData, Parameters, Exclusions, Predicate ) )
     {
         return( ErrorCode::ErrorCode_BadConstraints );
     }
-    _constraintWarnings.assign( interpreter.GetWarnings().begin(), interpreter.GetWarnings().end() );
+    _task.SetRowPredicate( &Predicate );
+    _constraintWarnings.assign( constraints.GetWarnings().begin(), constraints.GetWarnings().end() );
 
     if( _modelData.Verbose )
     {
@@ -297,6 +322,46 @@ ErrorCode CGcdData::TranslateToGCD()
         _task.AddExclusion( const_cast<Exclusion&> ( excl ) );
     }
 
+    return( ErrorCode::ErrorCode_Success );
+}
+
+//
+// the same model translated once more, for another seed say; instead of interpreting the
+// constraints it takes over the exclusions the other one derived, so it is ready for generation
+// afterwards and DeriveExclusions isn't called on it
+//
+ErrorCode CGcdData::TranslateToGCD( IN const CGcdData& derived )
+{
+    if( !translateModel() )
+    {
+        return( ErrorCode::ErrorCode_BadModel );
+    }
+
+    Predicate = derived.Predicate;
+    _task.SetRowPredicate( &Predicate );
+
+    // the parameters are numbered the same in both
+    for( auto & excl : derived.Exclusions )
+    {
+        Exclusion copy;
+        for( auto & term : excl )
+        {
+            copy.insert( make_pair( Parameters[ term.first->GetSequence() ], term.second ));
+        }
+        _task.AddExclusion( copy );
+    }
+
+    _task.SetExclusionsDerived( true );
+    _task.PrepareForGeneration();
+
+    return( ErrorCode::ErrorCode_Success );
+}
+
+//
+// the engine derives implicit exclusions from the ones given, the model is ready for generation afterwards
+//
+void CGcdData::DeriveExclusions()
+{
     _task.PrepareForGeneration();
 
     // at this point we don't need gcdData.Exclusions anymore
@@ -308,8 +373,6 @@ ErrorCode CGcdData::TranslateToGCD()
         PrintLogHeader( L"After derivation" );
         PrintGcdExclusions();
     }
-
-    return( ErrorCode::ErrorCode_Success );
 }
 
 //
@@ -337,76 +400,261 @@ void CGcdData::PrintGcdExclusions()
 }
 
 //
+// every operand counts towards the operator it is in, top-level expressions are in none
 //
+void CConstraintPredicate::addOperand()
+{
+    if( !_open.empty() )
+    {
+        ++_open.back().Operands;
+    }
+}
+
 //
-void CResult::PrintOutput( CModelData& modelData, wostream& wout )
+// the end and the counts are only known once the operator is closed
+//
+void CConstraintPredicate::open( IN bool all, IN unsigned int needed )
 {
-    wstring encodingPrefix;
-    setEncodingType( modelData.GetEncoding(), encodingPrefix );
-    wout << encodingPrefix;
+    addOperand();
+    _open.push_back( OpenOperator{ _code.size(), all, needed, 0 } );
+    _code.push_back( Opcode_Threshold );
+    _code.insert( _code.end(), 3, 0 );
+}
 
-    for( vector< CModelParameter >::iterator i_param =  modelData.Parameters.begin();
-                                             i_param != modelData.Parameters.end();
-                                             i_param++ )
+//
+//
+//
+void CConstraintPredicate::OpenAny()
+{
+    open( false, 1 );
+}
+
+//
+//
+//
+void CConstraintPredicate::OpenAll()
+{
+    open( true, 0 );
+}
+
+//
+//
+//
+void CConstraintPredicate::OpenAtLeast( IN unsigned int count )
+{
+    open( false, count );
+}
+
+//
+//
+//
+void CConstraintPredicate::Close()
+{
+    assert( !_open.empty() );
+    OpenOperator& oper = _open.back();
+    _code[ oper.At + 1 ] = static_cast< int >( _code.size() );
+    _code[ oper.At + 2 ] = static_cast< int >( oper.All ? oper.Operands : oper.Needed );
+    _code[ oper.At + 3 ] = static_cast< int >( oper.Operands );
+    _open.pop_back();
+}
+
+//
+//
+//
+int CConstraintPredicate::addBits( IN const vector< bool >& values )
+{
+    int bits = static_cast< int >( _bits.size() );
+    _bits.resize( _bits.size() + ( values.size() + 63 ) / 64, 0 );
+    for( size_t bit = 0; bit < values.size(); ++bit )
     {
-        if( i_param != modelData.Parameters.begin() ) wout << RESULT_DELIMITER;
-        wout << i_param->Name;
+        if( values[ bit ] ) _bits[ bits + ( bit >> 6 ) ] |= uint64_t( 1 ) << ( bit & 63 );
     }
-    wout << endl;
+    return( bits );
+}
+
+//
+//
+//
+void CConstraintPredicate::AddValueTest( IN unsigned int paramIdx, IN const vector< bool >& values )
+{
+    addOperand();
+    int bits = addBits( values );
+    _code.push_back( Opcode_Value );
+    _code.push_back( static_cast< int >( paramIdx ));
+    _code.push_back( bits );
+}
 
-    for( vector< CRow >::iterator i_row =  TestCases.begin();
-                                  i_row != TestCases.end();
-                                  i_row++ )
+//
+// pairs are indexed by the first parameter's value times the second one's value count plus its value
+//
+void CConstraintPredicate::AddPairTest( IN unsigned int param1Idx, IN unsigned int param2Idx, IN unsigned int param2Count,
+                                        IN const vector< bool >& pairs )
+{
+    addOperand();
+    int bits = addBits( pairs );
+    _code.push_back( Opcode_Pair );
+    _code.push_back( static_cast< int >( param1Idx ));
+    _code.push_back( static_cast< int >( param2Idx ));
+    _code.push_back( static_cast< int >( param2Count ));
+    _code.push_back( bits );
+}
+
+//
+// evaluates the expression at pc and moves pc past it
+//
+bool CConstraintPredicate::evaluate( IN OUT size_t& pc, IN const vector< int >& values ) const
+{
+    switch( _code[ pc ] )
     {
-        for( wstrings::iterator i_value =  i_row->DecoratedValues.begin();
-                                i_value != i_row->DecoratedValues.end();
-                                i_value++ )
+    case Opcode_Threshold:
         {
-            if( i_value != i_row->DecoratedValues.begin() )
+            size_t end    = static_cast< size_t >( _code[ pc + 1 ] );
+            int    needed = _code[ pc + 2 ];
+            int    left   = _code[ pc + 3 ];
+            pc += 4;
+            while( needed > 0 && needed <= left )
             {
-                wout << RESULT_DELIMITER;
+                if( evaluate( pc, values )) --needed;
+                --left;
             }
-            wout << *i_value;
+            pc = end;
+            return( 0 == needed );
         }
-        wout << endl;
+    case Opcode_Value:
+        {
+            size_t param = static_cast< size_t >( _code[ pc + 1 ] );
+            int    bits  = _code[ pc + 2 ];
+            pc += 3;
+            int value = param < values.size() ? values[ param ] : -1;
+            return( value >= 0 && test( bits, value ));
+        }
+    case Opcode_Pair:
+        {
+            size_t param1 = static_cast< size_t >( _code[ pc + 1 ] );
+            size_t param2 = static_cast< size_t >( _code[ pc + 2 ] );
+            int    count2 = _code[ pc + 3 ];
+            int    bits   = _code[ pc + 4 ];
+            pc += 5;
+            int value1 = param1 < values.size() ? values[ param1 ] : -1;
+            int value2 = param2 < values.size() ? values[ param2 ] : -1;
+            return( value1 >= 0 && value2 >= 0 && test( bits, value1 * count2 + value2 ));
+        }
+    default:
+        assert( false );
+        return( false );
     }
 }
 
 //
 //
 //
-void CResult::PrintOutputJson( CModelData& modelData, wostream& wout )
+bool CConstraintPredicate::Violates( const vector< int >& values ) const
+{
+    assert( _open.empty() );
+    size_t pc = 0;
+    while( pc < _code.size() )
+    {
+        if( evaluate( pc, values )) return( true );
+    }
+    return( false );
+}
+
+//
+//
+//
+void CResultWriter::Begin()
 {
     wstring encodingPrefix;
-    setEncodingType( modelData.GetEncoding(), encodingPrefix );
-    wout << encodingPrefix;
+    setEncodingType( _modelData.GetEncoding(), encodingPrefix );
+    _wout << encodingPrefix;
+
+    if( isJson() )
+    {
+        _wout << "[" << endl;
+        return;
+    }
 
-    wout << "[" << endl;
-    size_t testCasesSize = TestCases.size();
-    for( size_t i = 0; i < testCasesSize; i++ )
+    for( vector< CModelParameter >::iterator i_param =  _modelData.Parameters.begin();
+                                             i_param != _modelData.Parameters.end();
+                                             i_param++ )
     {
-        wout << "  [" << endl;
-        size_t valuesSize = TestCases[i].Values.size();
+        if( i_param != _modelData.Parameters.begin() ) _wout << RESULT_DELIMITER;
+        _wout << i_param->Name;
+    }
+    _wout << endl;
+}
+
+//
+// in JSON the separator between two rows can only be written once the second one comes
+//
+void CResultWriter::Write( CRow& row )
+{
+    if( isJson() )
+    {
+        if( _rowCount > 0 )
+        {
+            _wout << "," << endl;
+        }
+        _wout << "  [" << endl;
+        size_t valuesSize = row.Values.size();
         for( size_t j = 0; j < valuesSize; j++ )
         {
-            wout << "    {" << endl;
-            wout << "    " << "  \"key\": \"" << modelData.Parameters[j].Name << "\"," << endl;
-            wout << "    " << "  \"value\": \"" << TestCases[i].Values[j] << "\"" << endl;
-            wout << "    }";
+            _wout << "    {" << endl;
+            _wout << "    " << "  \"key\": \"" << _modelData.Parameters[j].Name << "\"," << endl;
+            _wout << "    " << "  \"value\": \"" << row.Values[j] << "\"" << endl;
+            _wout << "    }";
             if( j < valuesSize - 1 )
             {
-                wout << ",";
+                _wout << ",";
             }
-            wout << endl;
+            _wout << endl;
         }
-        wout << "  ]";
-        if( i < testCasesSize - 1 )
+        _wout << "  ]";
+    }
+    else
+    {
+        for( wstrings::iterator i_value =  row.DecoratedValues.begin();
+                                i_value != row.DecoratedValues.end();
+                                i_value++ )
+        {
+            if( i_value != row.DecoratedValues.begin() )
+            {
+                _wout << RESULT_DELIMITER;
+            }
+            _wout << *i_value;
+        }
+        _wout << endl;
+    }
+    ++_rowCount;
+}
+
+//
+//
+//
+void CResultWriter::End()
+{
+    if( isJson() )
+    {
+        if( _rowCount > 0 )
         {
-            wout << ",";
+            _wout << endl;
         }
-        wout << endl;
+        _wout << "]" << endl;
     }
-    wout << "]" << endl;
+}
+
+//
+//
+//
+void CResult::PrintOutput( CModelData& modelData, wostream& wout )
+{
+    CResultWriter writer( modelData, wout );
+    writer.Begin();
+    for( auto & testCase : TestCases )
+    {
+        writer.Write( testCase );
+    }
+    writer.End();
 }
 
 //
@@ -541,6 +789,32 @@ bool CGcdData::fixModelAndSubmodelOrder()
 //
 void CGcdData::addExclusionsForNegativeRun()
 {
+    // for the predicate it is any two parameters having negative values
+    vector< unsigned int > negativeParams;
+    vector< vector< bool > > negativeValues;
+    for( size_t paramIdx = 0; paramIdx < _modelData.Parameters.size(); ++paramIdx )
+    {
+        vector< bool > negative;
+        for( auto & value : _modelData.Parameters[ paramIdx ].Values )
+        {
+            negative.push_back( !value.IsPositive() );
+        }
+        if( find( negative.begin(), negative.end(), true ) != negative.end() )
+        {
+            negativeParams.push_back( static_cast< unsigned int >( paramIdx ));
+            negativeValues.push_back( negative );
+        }
+    }
+    if( negativeParams.size() > 1 )
+    {
+        Predicate.OpenAtLeast( 2 );
+        for( size_t index = 0; index < negativeParams.size(); ++index )
+        {
+            Predicate.AddValueTest( negativeParams[ index ], negativeValues[ index ] );
+        }
+        Predicate.Close();
+    }
+
     for( size_t param1Idx = 0; param1Idx < _modelData.Parameters.size(); ++param1Idx )
     {
         CModelParameter& param1 = _modelData.Parameters[ param1Idx ];
@@ -6,6 +6,7 @@
 namespace pictcli_gcd
 {
 
+class ConstraintsInterpreter;
 
 //
 //
@@ -35,11 +36,88 @@ public:
     bool     Negative;
 };
 
+//
+// writes rows out in the format requested on the command line, one row at a time
+//
+class CResultWriter
+{
+public:
+    CResultWriter( CModelData& modelData, std::wostream& wout ) :
+        _modelData( modelData ), _wout( wout ), _rowCount( 0 ) {}
+
+    void Begin();
+    void Write( CRow& row );
+    void End();
+
+private:
+    CModelData&    _modelData;
+    std::wostream& _wout;
+    size_t         _rowCount;
+
+    bool isJson() { return( _modelData.Format == L"json" ); }
+};
+
 //
 //
 //
 typedef std::set< Exclusion > CGcdExclusions;
 
+//
+// the constraints compiled for checking rows directly, at a cost that follows the constraints'
+// text rather than the number of exclusions made of them
+//
+// a program is a list of expressions, the row violates the constraints if any one is true; each
+// is a test of a parameter's value or of two parameters' values against a bitset, or a threshold
+// over the expressions following it: at least one of them for OR, all for AND. Operators come
+// before their operands and know where they end so the rest can be skipped once decided. Tests
+// of parameters missing from the row are false, the expressions have no negations so a row only
+// fails when no values of the missing parameters could make it pass
+//
+class CConstraintPredicate : public RowPredicate
+{
+public:
+    // parameters are given by index which is also their sequence in the engine
+    void OpenAny();
+    void OpenAll();
+    void OpenAtLeast( IN unsigned int count );
+    void Close();
+    void AddValueTest( IN unsigned int paramIdx, IN const std::vector< bool >& values );
+    void AddPairTest ( IN unsigned int param1Idx, IN unsigned int param2Idx, IN unsigned int param2Count,
+                       IN const std::vector< bool >& pairs );
+
+    bool Violates( const std::vector< int >& values ) const override;
+
+private:
+    enum Opcode
+    {
+        Opcode_Threshold,   // end, operands needed, operands
+        Opcode_Value,       // parameter, bits
+        Opcode_Pair,        // first parameter, second parameter, its value count, bits
+    };
+
+    struct OpenOperator
+    {
+        size_t       At;
+        bool         All;
+        unsigned int Needed;
+        unsigned int Operands;
+    };
+
+    std::vector< int >          _code;
+    std::vector< uint64_t >     _bits;
+    std::vector< OpenOperator > _open;
+
+    void open( IN bool all, IN unsigned int needed );
+    void addOperand();
+    int  addBits( IN const std::vector< bool >& values );
+    bool evaluate( IN OUT size_t& pc, IN const std::vector< int >& values ) const;
+
+    bool test( IN int bits, IN size_t bit ) const
+    {
+        return( 0 != ( _bits[ bits + ( bit >> 6 ) ] & ( uint64_t( 1 ) << ( bit & 63 ))));
+    }
+};
+
 //
 //
 //
@@ -51,7 +129,6 @@ public:
     wstrings            SolverWarnings;
 
     void PrintOutput( CModelData& modelData, std::wostream& wout );
-    void PrintOutputJson( CModelData& modelData, std::wostream& wout );
     void PrintConstraintWarnings();
     void PrintStatistics();
 };
@@ -65,6 +142,7 @@ public:
     std::vector< Model* >     Models;
     std::vector< Parameter* > Parameters;
     CGcdExclusions            Exclusions;
+    CConstraintPredicate      Predicate;
 
     CGcdData( CModelData& modelData ) : _modelData( modelData ) {}
 
@@ -78,8 +156,11 @@ public:
         }
     }
 
-    ErrorCode TranslateToGCD();
+    ErrorCode TranslateToGCD( IN ConstraintsInterpreter& constraints );
+    ErrorCode TranslateToGCD( IN const CGcdData& derived );
+    void DeriveExclusions();
     bool FixParamOrder( IN Model* submodel );
+    bool FixParamOrder( IN const std::vector< Model* >& submodels );
     Model* GetRootModel() { return( _task.GetRootModel() ); }
 
     bool CheckEntireParameterExcluded();
@@ -93,6 +174,7 @@ private:
     Task        _task;
     wstrings    _constraintWarnings;
 
+    bool translateModel();
     bool fixModelAndSubmodelOrder();
     void addExclusionsForNegativeRun();
 };
@@ -0,0 +1,229 @@
+#include <limits>
+#include "gcdzdd.h"
+using namespace std;
+
+namespace pictcli_gcd
+{
+
+//
+// The terminals sort after all items so the top item of any family is that of its node
+//
+ExclusionFamilies::ExclusionFamilies( IN const vector< Parameter* >& parameters ) :
+    _parameters( parameters )
+{
+    for( unsigned int paramIdx = 0; paramIdx < _parameters.size(); ++paramIdx )
+    {
+        _paramBegin.push_back( static_cast< int >( _itemParam.size() ));
+        _itemParam.insert( _itemParam.end(), _parameters[ paramIdx ]->GetValueCount(), paramIdx );
+    }
+    _paramBegin.push_back( static_cast< int >( _itemParam.size() ));
+
+    _nodes.push_back( Node{ numeric_limits< int >::max(), Empty, Empty } );
+    _nodes.push_back( Node{ numeric_limits< int >::max(), Unit,  Unit  } );
+}
+
+//
+//
+//
+size_t ExclusionFamilies::NodeHash::operator()( const Node& node ) const
+{
+    size_t hash = static_cast< size_t >( node.Item );
+    hash = hash * 1000003 ^ static_cast< size_t >( node.Low );
+    hash = hash * 1000003 ^ static_cast< size_t >( node.High );
+    return( hash );
+}
+
+//
+// Nodes whose high branch is empty are left out, that's what keeps the diagram zero-suppressed
+//
+ExclusionFamilies::Family ExclusionFamilies::makeNode( IN int item, IN Family low, IN Family high )
+{
+    if( Empty == high ) return( low );
+
+    Node node{ item, low, high };
+    unordered_map< Node, Family, NodeHash, NodeEqual >::iterator found = _unique.find( node );
+    if( found != _unique.end() ) return( found->second );
+
+    Family family = static_cast< Family >( _nodes.size() );
+    _nodes.push_back( node );
+    _unique.insert( make_pair( node, family ));
+    return( family );
+}
+
+//
+//
+//
+ExclusionFamilies::Family ExclusionFamilies::Single( IN unsigned int paramIdx, IN unsigned int valueIdx )
+{
+    assert( paramIdx < _parameters.size() );
+    assert( _paramBegin[ paramIdx ] + static_cast< int >( valueIdx ) < _paramBegin[ paramIdx + 1 ] );
+    return( makeNode( _paramBegin[ paramIdx ] + valueIdx, Empty, Unit ));
+}
+
+//
+// Goes down the low branches as long as the result splits there, deep recursion would be
+//  needed for parameters with many values otherwise; the nodes are made on the way back up
+//
+ExclusionFamilies::Family ExclusionFamilies::Union( IN Family family1, IN Family family2 )
+{
+    size_t base = _pending.size();
+
+    Family result;
+    for( ;; )
+    {
+        if( Empty == family1 || family1 == family2 ) { result = family2; break; }
+        if( Empty == family2 ) { result = family1; break; }
+
+        if( family1 > family2 ) swap( family1, family2 );
+        uint64_t key = cacheKey( family1, family2 );
+        unordered_map< uint64_t, Family >::iterator found = _unionCache.find( key );
+        if( found != _unionCache.end() ) { result = found->second; break; }
+
+        // the node may move as the vector of nodes grows, take a copy
+        Node node1 = _nodes[ family1 ];
+        Node node2 = _nodes[ family2 ];
+
+        if( node1.Item < node2.Item )
+        {
+            _pending.push_back( Pending{ key, node1.Item, node1.High } );
+            family1 = node1.Low;
+        }
+        else if( node2.Item < node1.Item )
+        {
+            _pending.push_back( Pending{ key, node2.Item, node2.High } );
+            family2 = node2.Low;
+        }
+        else
+        {
+            // only the unit family has no item and it is covered by the equality above
+            Family high = Union( node1.High, node2.High );
+            _pending.push_back( Pending{ key, node1.Item, high } );
+            family1 = node1.Low;
+            family2 = node2.Low;
+        }
+    }
+
+    return( makePending( base, result, _unionCache ));
+}
+
+//
+// Nodes left on the way down, bottom up, each one's result the low branch of the one above
+//
+ExclusionFamilies::Family ExclusionFamilies::makePending( IN size_t base, IN Family low,
+                                                           IN OUT unordered_map< uint64_t, Family >& cache )
+{
+    while( _pending.size() > base )
+    {
+        Pending pending = _pending.back();
+        _pending.pop_back();
+
+        low = makeNode( pending.Item, low, pending.High );
+        cache.insert( make_pair( pending.Key, low ));
+    }
+    return( low );
+}
+
+//
+// Of the exclusions in a family, those with no value of the parameter
+//
+ExclusionFamilies::Family ExclusionFamilies::withoutParameter( IN Family family, IN unsigned int paramIdx )
+{
+    while( _nodes[ family ].Item >= _paramBegin[ paramIdx ] && _nodes[ family ].Item < _paramBegin[ paramIdx + 1 ] )
+    {
+        family = _nodes[ family ].Low;
+    }
+    return( family );
+}
+
+//
+// Every exclusion of one family merged with every exclusion of the other; when both sides
+//  split on the same item, the side that has the item can't take another value of its
+//  parameter from the other side
+//
+ExclusionFamilies::Family ExclusionFamilies::Product( IN Family family1, IN Family family2 )
+{
+    size_t base = _pending.size();
+
+    // the products of the low branches are taken one after another, like in Union
+    Family result;
+    for( ;; )
+    {
+        if( Empty == family1 || Empty == family2 ) { result = Empty; break; }
+        if( Unit == family1 ) { result = family2; break; }
+        if( Unit == family2 ) { result = family1; break; }
+
+        if( family1 > family2 ) swap( family1, family2 );
+        uint64_t key = cacheKey( family1, family2 );
+        unordered_map< uint64_t, Family >::iterator found = _productCache.find( key );
+        if( found != _productCache.end() ) { result = found->second; break; }
+
+        Node node1 = _nodes[ family1 ];
+        Node node2 = _nodes[ family2 ];
+
+        int item = min( node1.Item, node2.Item );
+        unsigned int paramIdx = _itemParam[ item ];
+
+        Family low1  = node1.Item == item ? node1.Low  : family1;
+        Family high1 = node1.Item == item ? node1.High : Empty;
+        Family low2  = node2.Item == item ? node2.Low  : family2;
+        Family high2 = node2.Item == item ? node2.High : Empty;
+
+        // looking for the values of the parameter takes a walk down the low branches, only done
+        //  when there is something to pair them with
+        Family high = Product( high1, high2 );
+        if( Empty != high1 ) high = Union( high, Product( high1, withoutParameter( low2, paramIdx )));
+        if( Empty != high2 ) high = Union( high, Product( withoutParameter( low1, paramIdx ), high2 ));
+
+        _pending.push_back( Pending{ key, item, high } );
+        family1 = low1;
+        family2 = low2;
+    }
+
+    return( makePending( base, result, _productCache ));
+}
+
+//
+// The low branches are followed right away and the high ones kept for later, each with
+//  the number of items on the way to it and its own item
+//
+void ExclusionFamilies::Extract( IN Family family, IN OUT CGcdExclusions& gcdExclusions )
+{
+    struct Branch
+    {
+        Family High;
+        size_t Depth;
+        int    Item;
+    };
+
+    vector< Branch > branches;
+    vector< int >    items;
+    for( ;; )
+    {
+        while( Empty != family && Unit != family )
+        {
+            const Node& node = _nodes[ family ];
+            branches.push_back( Branch{ node.High, items.size(), node.Item } );
+            family = node.Low;
+        }
+
+        if( Unit == family )
+        {
+            Exclusion newExcl;
+            for( auto item : items )
+            {
+                unsigned int paramIdx = _itemParam[ item ];
+                newExcl.insert( make_pair( _parameters[ paramIdx ], item - _paramBegin[ paramIdx ] ));
+            }
+            gcdExclusions.insert( newExcl );
+        }
+
+        if( branches.empty() ) break;
+
+        items.resize( branches.back().Depth );
+        items.push_back( branches.back().Item );
+        family = branches.back().High;
+        branches.pop_back();
+    }
+}
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include "gcdmodel.h"
+
+namespace pictcli_gcd
+{
+
+//
+// Families of exclusions kept as a zero-suppressed decision diagram. Every node tests one
+// parameter value and every path to the unit family is an exclusion; subfamilies that are
+// equal are stored once so unions and products of wide value lists stay small until the
+// exclusions are taken out at the end.
+//
+// Values are numbered parameter by parameter and families never hold two values of the same
+// parameter, products drop such combinations as they are made.
+//
+class ExclusionFamilies
+{
+public:
+    typedef int Family;
+
+    static const Family Empty = 0;   // no exclusions at all
+    static const Family Unit  = 1;   // one exclusion with no terms
+
+    ExclusionFamilies( IN const std::vector< Parameter* >& parameters );
+
+    Family Single ( IN unsigned int paramIdx, IN unsigned int valueIdx );
+    Family Union  ( IN Family family1, IN Family family2 );
+    Family Product( IN Family family1, IN Family family2 );
+
+    void Extract( IN Family family, IN OUT CGcdExclusions& gcdExclusions );
+
+private:
+    struct Node
+    {
+        int    Item;
+        Family Low;     // exclusions without the item
+        Family High;    // exclusions with the item, less the item itself
+    };
+
+    // a node whose low branch is still being worked out
+    struct Pending
+    {
+        uint64_t Key;
+        int      Item;
+        Family   High;
+    };
+
+    struct NodeHash
+    {
+        size_t operator()( const Node& node ) const;
+    };
+
+    struct NodeEqual
+    {
+        bool operator()( const Node& node1, const Node& node2 ) const
+        {
+            return( node1.Item == node2.Item && node1.Low == node2.Low && node1.High == node2.High );
+        }
+    };
+
+    const std::vector< Parameter* >& _parameters;
+
+    // items are numbered parameter by parameter, for each item the parameter it belongs to
+    //  and for each parameter its first item
+    std::vector< unsigned int > _itemParam;
+    std::vector< int >          _paramBegin;
+
+    std::vector< Node >                                     _nodes;
+    std::unordered_map< Node, Family, NodeHash, NodeEqual > _unique;
+    std::unordered_map< uint64_t, Family >                  _unionCache;
+    std::unordered_map< uint64_t, Family >                  _productCache;
+    std::vector< Pending >                                  _pending;
+
+    Family makeNode( IN int item, IN Family low, IN Family high );
+    Family makePending( IN size_t base, IN Family low, IN OUT std::unordered_map< uint64_t, Family >& cache );
+    Family withoutParameter( IN Family family, IN unsigned int paramIdx );
+
+    static uint64_t cacheKey( IN Family family1, IN Family family2 )
+    {
+        return( ( static_cast< uint64_t >( family1 ) << 32 ) | static_cast< uint32_t >( family2 ) );
+    }
+};
+
+}
@@ -1,5 +1,5 @@
 #include <sstream>
-#include "model.h"
+#include "cmdline.h"
 using namespace std;
 
 // ****************************************************************************
@@ -30,6 +30,58 @@ std::wstring CModelValue::GetNextName()
     return( _names[ _currentNameIndex++ ] );
 }
 
+// ****************************************************************************
+//
+// CValueDictionary
+//
+// ****************************************************************************
+
+//
+//
+//
+void CValueDictionary::Build( IN vector< CModelValue >& values, IN bool caseSensitive )
+{
+    _caseSensitive = caseSensitive;
+    _allNumbers    = true;
+    _nameBegin.clear();
+    _numbers.clear();
+    _keyBegin.clear();
+    _keys.clear();
+
+    for( auto & value : values )
+    {
+        _nameBegin.push_back( static_cast< unsigned int >( _numbers.size() ));
+        for( auto & name : value.GetNamesForComparisons() )
+        {
+            double number;
+            if( !stringToNumber( name, number ))
+            {
+                number = numeric_limits< double >::quiet_NaN();
+                _allNumbers = false;
+            }
+            _numbers.push_back( number );
+
+            _keyBegin.push_back( static_cast< unsigned int >( _keys.size() ));
+            _keys += MakeKey( name );
+            _keys += L'\0';
+        }
+    }
+    _nameBegin.push_back( static_cast< unsigned int >( _numbers.size() ));
+}
+
+//
+//
+//
+wstring CValueDictionary::MakeKey( IN const wstring& name ) const
+{
+    wstring key( name );
+    if( !_caseSensitive )
+    {
+        toUpper( key );
+    }
+    return( key );
+}
+
 // ****************************************************************************
 //
 // CModelParameter
@@ -159,6 +211,19 @@ void CModelData::RemoveNegativeValues()
         param.Values = newValues;
     }
     m_hasNegativeValues = false;
+
+    buildValueDictionaries();
+}
+
+//
+//
+//
+void CModelData::buildValueDictionaries()
+{
+    for( auto & param : Parameters )
+    {
+        param.Dictionary.Build( param.Values, CaseSensitive );
+    }
 }
 
 //
@@ -264,6 +329,19 @@ void CModelData::PrintStatistics()
     }
 }
 
+//
+// if r has been provided then print out the seed, the same goes for the winner of a portfolio
+// TODO: change to not use SWITCH_RANDOMIZE const
+//
+void CModelData::PrintUsedSeed()
+{
+    if( ProvidedArguments.find( SWITCH_RANDOMIZE ) != ProvidedArguments.end()
+     || ProvidedArguments.find( SWITCH_PORTFOLIO ) != ProvidedArguments.end() )
+    {
+        wcerr << L"Used seed: " << RandSeed << endl;
+    }
+}
+
 //
 //
 //
@@ -46,6 +46,40 @@ private:
     wstrings::size_type _currentNameIndex;
 };
 
+//
+// The names values are compared by, parsed once when the model is read: numbers in one array,
+// keys in one buffer and, for each value, the range of its names. Keys are upper-cased unless
+// the model is case-sensitive and each ends with a null so it can be used as a C string.
+//
+class CValueDictionary
+{
+public:
+    CValueDictionary() : _caseSensitive( false ), _allNumbers( true ) {}
+
+    void Build( IN std::vector< CModelValue >& values, IN bool caseSensitive );
+
+    // the key a name from outside the model is compared to the keys of the values by
+    std::wstring MakeKey( IN const std::wstring& name ) const;
+
+    size_t GetValueCount() const { return( _nameBegin.empty() ? 0 : _nameBegin.size() - 1 ); }
+    unsigned int NameBegin( unsigned int valueIdx ) const { return( _nameBegin[ valueIdx ] ); }
+    unsigned int NameEnd  ( unsigned int valueIdx ) const { return( _nameBegin[ valueIdx + 1 ] ); }
+
+    double         GetNumber( unsigned int nameIdx ) const { return( _numbers[ nameIdx ] ); }
+    const wchar_t* GetKey   ( unsigned int nameIdx ) const { return( _keys.c_str() + _keyBegin[ nameIdx ] ); }
+
+    // whether every name is a number, then the parameter is numeric
+    bool AllNumbers() const { return( _allNumbers ); }
+
+private:
+    bool                        _caseSensitive;
+    bool                        _allNumbers;
+    std::vector< unsigned int > _nameBegin;  // one more than there are values
+    std::vector< double >       _numbers;    // NaN for names that are not numbers
+    std::vector< unsigned int > _keyBegin;
+    std::wstring                _keys;
+};
+
 //
 //
 //
@@ -57,6 +91,7 @@ public:
     unsigned int               Order;             // default order assigned when parameter is defined
     bool                       IsResultParameter; // special parameter for results
     Parameter*                 GcdPointer;
+    CValueDictionary           Dictionary;        // names of Values for evaluating constraints
 
     CModelParameter() :
         Name(L""),
@@ -98,12 +133,17 @@ public:
     wchar_t                   ValuesDelim;
     wchar_t                   NamesDelim;
     wchar_t                   InvalidPrefix;
-    unsigned short            RandSeed;
+    unsigned int              RandSeed;
     bool                      CaseSensitive;
     bool                      Verbose;         // prints out some additional info while generating
     bool                      Statistics;      // show the statistics only
     pictcore::GenerationMode  GenerationMode;
     size_t                    MaxApproxTries;  // for Approximate mode
+    unsigned int              ThreadCount;     // threads the engine may use, results do not depend on it
+    unsigned int              CandidateCount;  // rows built for each one kept
+    unsigned int              PortfolioSize;   // generations with consecutive seeds, the smallest result wins
+    bool                      CompactResults;  // drop rows that add no coverage of their own
+    bool                      LazyConstraints; // no implied exclusions derived, rows checked as built
 
     std::wstring                   RowSeedsFile;
     std::wstring                   Format;
@@ -126,6 +166,11 @@ public:
         Statistics(false),
         GenerationMode(GenerationMode::Regular),
         MaxApproxTries(1000),
+        ThreadCount(1),
+        CandidateCount(1),
+        PortfolioSize(1),
+        CompactResults(false),
+        LazyConstraints(false),
         RowSeedsFile(L""),
         ConstraintPredicates(L""),
         m_hasNegativeValues(false),
@@ -155,6 +200,7 @@ public:
 
     void PrintModelContents( std::wstring title );
     void PrintStatistics();
+    void PrintUsedSeed();
     
 private:
     bool            m_hasNegativeValues;
@@ -167,4 +213,5 @@ private:
     bool readParameter             ( std::wstring& line );
     bool readParamSet              ( std::wstring& line );
     void getUnmatchedParameterNames( wstrings& paramsOfSubmodel, wstrings& unmatchedParams );
+    void buildValueDictionaries    ();
 };
@@ -528,6 +528,7 @@ bool CModelData::ReadModel( const wstring& filePath )
         return( false );
     }
 
+    buildValueDictionaries();
     return( true );
 }
 
@@ -39,13 +39,15 @@ void printTimeDifference( time_t start, time_t end )
 }
 
 //
+// when a stream is given, rows that can be written out while the generation
+// is still running go there directly and never make it to the output string
 //
-//
-int __cdecl execute
+int run
     (
-    IN     int      argc,
-    IN     wchar_t* args[],
-    IN OUT wstring& output
+    IN     int       argc,
+    IN     wchar_t*  args[],
+    IN OUT wstring&  output,
+    IN     wostream* stream
     )
 {
     time_t start = time( nullptr );
@@ -67,7 +69,7 @@ int __cdecl execute
         return( (int)ErrorCode::ErrorCode_BadRowSeedFile );
     }
 
-    GcdRunner gcdRunner( modelData );
+    GcdRunner gcdRunner( modelData, stream );
 
     ErrorCode err = gcdRunner.Generate();
     if( err != ErrorCode::ErrorCode_Success )
@@ -77,11 +79,10 @@ int __cdecl execute
 
     time_t end = time( nullptr );
 
-    // if r has been provided then print out the seed
-    // TODO: change to not use SWITCH_RANDOMIZE const
-    if( modelData.ProvidedArguments.find( SWITCH_RANDOMIZE ) != modelData.ProvidedArguments.end() )
+    // streamed rows came with the seed and the warnings ahead of them
+    if( !gcdRunner.IsStreamed() )
     {
-        wcerr << L"Used seed: " << static_cast<int>( modelData.RandSeed ) << endl;
+        modelData.PrintUsedSeed();
     }
 
     CResult result = gcdRunner.GetResult();
@@ -93,25 +94,31 @@ int __cdecl execute
         PrintStatisticsCaption( wstring( L"Generation time" ));
         printTimeDifference( start, end );
     }
-    else
+    else if( !gcdRunner.IsStreamed() )
     {
         result.PrintConstraintWarnings();
 
         wostringstream outputStream;
-        if( modelData.Format == L"json" )
-        {
-            result.PrintOutputJson( modelData, outputStream );
-        }
-        else
-        {
-            result.PrintOutput( modelData, outputStream );
-        }
+        result.PrintOutput( modelData, outputStream );
         output.append( outputStream.str() );
     }
 
     return( (int)ErrorCode::ErrorCode_Success );
 }
 
+//
+//
+//
+int __cdecl execute
+    (
+    IN     int      argc,
+    IN     wchar_t* args[],
+    IN OUT wstring& output
+    )
+{
+    return( run( argc, args, output, nullptr ) );
+}
+
 //
 //
 //
@@ -136,7 +143,7 @@ int __cdecl wmain
     }
 
     wstring output;
-    int ret = execute( argc, args, output );
+    int ret = run( argc, args, output, &std::wcout );
 
     std::wcout << output;
 
@@ -97,6 +97,12 @@ bool patternMatch
     IN std::wstring text
     );
 
+bool patternMatch
+    (
+    IN const wchar_t* pattern,
+    IN const wchar_t* text
+    );
+
 //
 // Converts a char to a string
 //
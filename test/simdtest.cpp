@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "simd.h"
+using namespace pictcore;
+using namespace std;
+
+//
+// Checks the kernels the library picked for this processor against the portable versions
+// Lengths run across the vector widths and their remainders, both above and below
+//  MinVectorCount, starting at every offset within a vector
+//
+
+namespace
+{
+
+mt19937 g_random( 2024 );
+int     g_failures = 0;
+
+//
+//
+//
+void check( bool ok, const char* kernel, int count, int offset, int extra )
+{
+    if( !ok )
+    {
+        fprintf( stderr, "%s differs from the portable version: count %d offset %d (%d)\n", kernel, count, offset, extra );
+        ++g_failures;
+    }
+}
+
+//
+//
+//
+vector<int> randomKeys( int count )
+{
+    uniform_int_distribution<int> key( 0, 1000 );
+    vector<int> keys( count );
+    for( auto& k : keys ) k = key( g_random );
+    return( keys );
+}
+
+//
+//
+//
+void testScaleAdd( int count, int offset )
+{
+    vector<int> kernel   = randomKeys( offset + count );
+    vector<int> portable = kernel;
+    for( int factor = 1; factor <= 7; factor += 3 )
+    {
+        simd::ScaleAddKernel  ( kernel.data()   + offset, count, factor, factor - 1 );
+        simd::ScaleAddPortable( portable.data() + offset, count, factor, factor - 1 );
+        check( kernel == portable, "ScaleAdd", count, offset, factor );
+    }
+}
+
+//
+//
+//
+void testExpand( int count, int offset )
+{
+    for( int valueCount = 1; valueCount <= 5; ++valueCount )
+    {
+        vector<int> kernel = randomKeys( offset + count * valueCount );
+        vector<int> portable = kernel;
+        simd::ExpandKernel  ( kernel.data()   + offset, count, valueCount );
+        simd::ExpandPortable( portable.data() + offset, count, valueCount );
+        check( kernel == portable, "Expand", count, offset, valueCount );
+    }
+}
+
+//
+//
+//
+void testCounts( const vector<uint64_t>& plane, int count, int offset )
+{
+    int bits = static_cast<int>( plane.size() ) * 64;
+
+    uniform_int_distribution<int> position( 0, bits - 1 );
+    vector<int> positions( offset + count );
+    for( auto& p : positions ) p = position( g_random );
+    check( simd::CountSetKernel( plane.data(), positions.data() + offset, count )
+        == simd::CountSetPortable( plane.data(), positions.data() + offset, count ), "CountSet", count, offset, 0 );
+
+    // runs spanning up to all the words of the plane
+    for( int length : { count, count * 9 } )
+    {
+        for( int first = offset; first + length <= bits; first += 61 )
+        {
+            check( simd::CountRunKernel( plane.data(), first, length )
+                == simd::CountRunPortable( plane.data(), first, length ), "CountRun", length, offset, first );
+        }
+    }
+}
+
+}
+
+//
+//
+//
+int main()
+{
+    vector<uint64_t> sparse( 8 ), dense( 8 ), full( 8, ~uint64_t( 0 ) );
+    for( auto& w : sparse ) w = g_random() & g_random() & g_random();
+    for( auto& w : dense )  w = static_cast<uint64_t>( g_random() ) << 32 | g_random();
+
+    for( int count = 0; count <= 3 * simd::MinVectorCount + 1; ++count )
+    {
+        for( int offset = 0; offset < 8; ++offset )
+        {
+            testScaleAdd( count, offset );
+            testExpand( count, offset );
+            testCounts( sparse, count, offset );
+            testCounts( dense,  count, offset );
+            testCounts( full,   count, offset );
+        }
+    }
+
+    if( g_failures > 0 )
+    {
+        fprintf( stderr, "%d mismatches\n", g_failures );
+        return( 1 );
+    }
+    return( 0 );
+}
@@ -18,6 +18,10 @@ my $SWITCH_FINAL     = "/final";     # switch: this is a final run, leave out ve
 my $FAILLOG_FILE     = ".failures";  # suffix of a log storing summary of failures
 
 my $OPTION_NOSEEDING = "NO_SEEDING"; # should skip seeding tests
+my $OPTION_PORTFOLIO = "PORTFOLIO";  # /k:N should pick the smallest of its N runs and replay under /r
+my $OPTION_COVERAGE  = "COVERAGE";   # the suite must cover the same tuples as one made without /b /k /l /m /t
+my $OPTION_THREADS   = "THREADS";    # the output must be the same as with /t:1
+my $OPTION_STREAMING = "STREAMING";  # without /v rows go out as they come: no output on errors, the seed first
 
 #
 # parse parameters
@@ -220,6 +224,42 @@ sub processCommand {
     logText( $out, "STDERR:" . "\n" );
     logText( $out, $ostderr_all  . "\n" );
 
+    #
+    # streaming testing
+    #
+    if( $expresult eq $result and
+        $options =~ /.*$OPTION_STREAMING.*/ )
+    {
+        checkStreaming( $exe, $filepath, $cmdline, $out, $result );
+    }
+
+    #
+    # portfolio testing
+    #
+    if( $result eq 0 and
+        $options =~ /.*$OPTION_PORTFOLIO.*/ )
+    {
+        checkPortfolio( $exe, $filepath, $cmdline, $out );
+    }
+
+    #
+    # coverage testing
+    #
+    if( $result eq 0 and
+        $options =~ /.*$OPTION_COVERAGE.*/ )
+    {
+        checkCoverage( $exe, $filepath, $cmdline, $out );
+    }
+
+    #
+    # thread count testing
+    #
+    if( $result eq 0 and
+        $options =~ /.*$OPTION_THREADS.*/ )
+    {
+        checkThreads( $exe, $filepath, $cmdline, $out );
+    }
+
     #
     # seeding testing
     #
@@ -251,6 +291,254 @@ sub processCommand {
     unlink(".stderr2");
 }
 
+#############################################
+#
+# Runs each seed of a /k:N portfolio on its own
+# and checks the one reported as used is the
+# first of the smallest results and replays it
+#
+#############################################
+sub checkPortfolio {
+
+    my $exe;       # which exe should be tested
+    my $filepath;  #
+    my $cmdline;   # what was run, /v included
+    my $out;       # output file
+
+    ($exe, $filepath, $cmdline, $out) = @_;
+
+    $cmdline =~ s/ \/v$//;
+    my ($size)  = ( $cmdline =~ /[\/-]k:(\d+)/i );
+    my ($first) = ( $cmdline =~ /[\/-]r:(\d+)/i );
+    if ( $first eq "" ) {
+        $first = 0;
+    }
+
+    system("$exe $filepath$cmdline 1>.stdout3 2>.stderr3");
+    open( OSTDOUT3, ".stdout3" );
+    my $portfolio = join( "", <OSTDOUT3> );
+    close OSTDOUT3;
+    open( OSTDERR3, ".stderr3" );
+    my ($used) = ( join( "", <OSTDERR3> ) =~ /Used seed: (\d+)/ );
+    close OSTDERR3;
+
+    my $single = $cmdline;
+    $single =~ s/\s*[\/-]k:\d+//i;
+    $single =~ s/\s*[\/-]r:\d+//i;
+
+    my $best;      # first seed of the smallest result
+    my $bestrows;
+    my $replay;    # what the used seed makes on its own
+    for ( my $seed = $first; $seed < $first + $size; $seed++ ) {
+        system("$exe $filepath$single /r:$seed 1>.stdout3 2>.stderr3");
+        open( OSTDOUT3, ".stdout3" );
+        my @rows = <OSTDOUT3>;
+        close OSTDOUT3;
+
+        if ( $bestrows eq "" or @rows < $bestrows ) {
+            $best     = $seed;
+            $bestrows = @rows;
+        }
+        if ( $seed eq $used ) {
+            $replay = join( "", @rows );
+        }
+    }
+
+    logText( $out, "+++++++++++++++++++++++++++++++++++\n\n" );
+    logText( $out, "PORTFOLIO: " );
+
+    if ( $used ne "" and $used eq $best and $replay eq $portfolio ) {
+        logText( $out, "OK\n" );
+    } else {
+        logText( $out, "!!! FAILED !!! used " . $used . ", smallest " . $best . "\n" );
+        print STDOUT "ERROR: portfolio failure\n";
+        logText( $out . $FAILLOG_FILE, "Portfolio failure    " . $cmdline . "\n" );
+    }
+
+    unlink(".stdout3");
+    unlink(".stderr3");
+}
+
+#############################################
+#
+# Runs the command without /v so that the rows
+# are written out while they're generated;
+# a failed run must not have written anything
+# and the seed must come ahead of the warnings
+#
+#############################################
+sub checkStreaming {
+
+    my $exe;       # which exe should be tested
+    my $filepath;  #
+    my $cmdline;   # what was run, /v included
+    my $out;       # output file
+    my $result;    # what the run with /v returned
+
+    ($exe, $filepath, $cmdline, $out, $result) = @_;
+
+    $cmdline =~ s/ \/v$//;
+    system("$exe $filepath$cmdline 1>.stdout3 2>.stderr3");
+    my $streamed = $? / 256;
+
+    open( OSTDOUT3, ".stdout3" );
+    my $ostdout_all = join( "", <OSTDOUT3> );
+    close OSTDOUT3;
+
+    open( OSTDERR3, ".stderr3" );
+    my $ostderr_all = join( "", <OSTDERR3> );
+    close OSTDERR3;
+
+    logText( $out, "+++++++++++++++++++++++++++++++++++\n\n" );
+    logText( $out, "STREAMED STDERR:" . "\n" );
+    logText( $out, $ostderr_all . "\n" );
+    logText( $out, "STREAMING: " );
+
+    if ( $streamed eq $result
+     and ( $result eq 0 or $ostdout_all eq "" )
+     and not ( $ostderr_all =~ /.+\n.*Used seed/s ) ) {
+        logText( $out, "OK\n" );
+    } else {
+        logText( $out, "!!! FAILED !!!\n" );
+        print STDOUT "ERROR: streaming failure\n";
+        logText( $out . $FAILLOG_FILE, "Streaming failure    " . $cmdline . "\n" );
+    }
+
+    unlink(".stdout3");
+    unlink(".stderr3");
+}
+
+#############################################
+#
+# Runs the command again on one thread, the
+# output must not change
+#
+#############################################
+sub checkThreads {
+
+    my $exe;       # which exe should be tested
+    my $filepath;  #
+    my $cmdline;   # what was run, /v included
+    my $out;       # output file
+
+    ($exe, $filepath, $cmdline, $out) = @_;
+
+    $cmdline =~ s/ \/v$//;
+    my $single = $cmdline;
+    $single =~ s/[\/-]t:\d+/\/t:1/i;
+
+    system("$exe $filepath$cmdline 1>.stdout3 2>.stderr3");
+    open( OSTDOUT3, ".stdout3" );
+    my $threaded = join( "", <OSTDOUT3> );
+    close OSTDOUT3;
+
+    system("$exe $filepath$single 1>.stdout3 2>.stderr3");
+    open( OSTDOUT3, ".stdout3" );
+    my $serial = join( "", <OSTDOUT3> );
+    close OSTDOUT3;
+
+    logText( $out, "+++++++++++++++++++++++++++++++++++\n\n" );
+    logText( $out, "THREADS: " );
+
+    if ( $threaded eq $serial ) {
+        logText( $out, "OK\n" );
+    } else {
+        logText( $out, "!!! FAILED !!!\n" );
+        print STDOUT "ERROR: thread count failure\n";
+        logText( $out . $FAILLOG_FILE, "Thread count failure    " . $cmdline . "\n" );
+    }
+
+    unlink(".stdout3");
+    unlink(".stderr3");
+}
+
+#############################################
+#
+# Compares the t-wise tuples of the suite with
+# those of the suite made the regular way, with
+# the switches that only change how rows are
+# picked or how many of them stay left out
+#
+#############################################
+sub checkCoverage {
+
+    my $exe;       # which exe should be tested
+    my $filepath;  #
+    my $cmdline;   # what was run, /v included
+    my $out;       # output file
+
+    ($exe, $filepath, $cmdline, $out) = @_;
+
+    $cmdline =~ s/ \/v$//;
+    my ($order) = ( $cmdline =~ /[\/-]o:(\d+)/i );
+    if ( $order eq "" ) {
+        $order = 2;
+    }
+
+    my $regular = $cmdline;
+    $regular =~ s/\s*[\/-][ml](?=\s|$)//gi;
+    $regular =~ s/\s*[\/-][bkt]:\d+//gi;
+
+    my %tuples  = coveredTuples( $exe, $filepath, $cmdline, $order );
+    my %regular = coveredTuples( $exe, $filepath, $regular, $order );
+
+    my $missing = grep { not exists $tuples{$_} } keys %regular;
+    my $extra   = grep { not exists $regular{$_} } keys %tuples;
+
+    logText( $out, "+++++++++++++++++++++++++++++++++++\n\n" );
+    logText( $out, "COVERAGE: " );
+
+    if ( %regular and $missing eq 0 and $extra eq 0 ) {
+        logText( $out, "OK\n" );
+    } else {
+        logText( $out, "!!! FAILED !!! " . $missing . " missing, " . $extra . " extra\n" );
+        print STDOUT "ERROR: coverage failure\n";
+        logText( $out . $FAILLOG_FILE, "Coverage failure    " . $cmdline . "\n" );
+    }
+}
+
+#############################################
+#
+# Runs a command and collects all the t-wise
+# tuples of values its rows hold
+#
+#############################################
+sub coveredTuples {
+
+    my ($exe, $filepath, $cmdline, $order) = @_;
+
+    system("$exe $filepath$cmdline 1>.stdout3 2>.stderr3");
+    open( OSTDOUT3, ".stdout3" );
+    my @rows = <OSTDOUT3>;
+    close OSTDOUT3;
+    unlink(".stdout3");
+    unlink(".stderr3");
+
+    shift @rows; # header
+
+    my %tuples;
+    foreach my $row (@rows) {
+        $row =~ s/[\r\n]+$//;
+        my @values = split( /\t/, $row );
+        my $size = $order < @values ? $order : @values;
+        collectTuples( \%tuples, \@values, $size, 0, "" );
+    }
+    return %tuples;
+}
+
+sub collectTuples {
+
+    my ($tuples, $values, $left, $first, $prefix) = @_;
+
+    if ( $left eq 0 ) {
+        $tuples->{$prefix} = 1;
+        return;
+    }
+    for ( my $n = $first; $n <= @$values - $left; $n++ ) {
+        collectTuples( $tuples, $values, $left - 1, $n + 1, $prefix . $n . "=" . $values->[$n] . "\t" );
+    }
+}
+
 #############################################
 #
 # Logs a line of text